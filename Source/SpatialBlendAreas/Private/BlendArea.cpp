@@ -9,6 +9,7 @@ subjected to the respective product licensing terms.
 ******************************************************************************************************/
 
 #include "BlendArea.h"
+#include "BlendAreaSubsystem.h"
 
 ABlendArea::ABlendArea()
 	:BlendDistance(0.0), Priority(0)
@@ -17,11 +18,67 @@ ABlendArea::ABlendArea()
 
 void ABlendArea::BeginPlay()
 {
-	Super::BeginPlay();	
+	Super::BeginPlay();
+
+	// Registered up front, so that the proximity queries also see areas no weight manager references.
+	if (UBlendAreaSubsystem* Subsystem = UWorld::GetSubsystem<UBlendAreaSubsystem>(GetWorld()))
+	{
+		Subsystem->RegisterArea(this);
+	}
+}
+
+void ABlendArea::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Streamed out and destroyed areas leave the registry, so it does not grow over a long session.
+	if (UBlendAreaSubsystem* Subsystem = UWorld::GetSubsystem<UBlendAreaSubsystem>(GetWorld()))
+	{
+		Subsystem->UnregisterArea(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ABlendArea::SetPriority(const uint32 InPriority)
+{
+	if (Priority == InPriority)
+	{
+		return;
+	}
+
+	Priority = InPriority;
+
+	if (UBlendAreaSubsystem* Subsystem = UWorld::GetSubsystem<UBlendAreaSubsystem>(GetWorld()))
+	{
+		Subsystem->RefreshArea(this);
+	}
+}
+
+void ABlendArea::InitializeArea()
+{
+	Super::InitializeArea();
 	BlendDistance = BlendDistance < 0 ? 0.0 : BlendDistance;
+
+	if (FalloffCurve != nullptr)
+	{
+		FalloffTable = FBlendFalloffTable::FindOrBake(FalloffCurve, GetFalloffDomain());
+	}
+	else
+	{
+		FalloffTable.Reset();
+	}
 }
 
 void ABlendArea::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 }
+
+void ABlendArea::EvaluateBatch(TArrayView<const ABlendArea* const> InAreas, const FVector& Point, TArrayView<float> OutWeights)
+{
+	check(InAreas.Num() == OutWeights.Num());
+
+	for (int32 Index = 0; Index < InAreas.Num(); Index++)
+	{
+		OutWeights[Index] = InAreas[Index] != nullptr ? InAreas[Index]->GetBlendWeight(Point) : 0.f;
+	}
+}
@@ -0,0 +1,84 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendAreaCommandletUtils.h"
+#include "BlendArea.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "UObject/Package.h"
+
+UWorld* BlendAreaCommandletUtils::LoadWorld(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package != nullptr ? UWorld::FindWorldInPackage(Package) : nullptr;
+
+	if (World == nullptr)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not load map '%s'."), *MapName)
+		return nullptr;
+	}
+
+	World->AddToRoot();
+
+	if (!World->bIsWorldInitialized)
+	{
+		World->WorldType = EWorldType::Editor;
+
+		// Only the actors are needed, so skip everything that is not required for reading their components.
+		UWorld::InitializationValues InitValues;
+		InitValues.InitializeScenes(false)
+				  .AllowAudioPlayback(false)
+				  .RequiresHitProxies(false)
+				  .CreatePhysicsScene(false)
+				  .CreateNavigation(false)
+				  .CreateAISystem(false)
+				  .ShouldSimulatePhysics(false)
+				  .EnableTraceCollision(false)
+				  .SetTransactional(false)
+				  .CreateFXSystem(false);
+
+		World->InitWorld(InitValues);
+	}
+
+	World->UpdateWorldComponents(true, false);
+	return World;
+}
+
+void BlendAreaCommandletUtils::UnloadWorld(UWorld* World)
+{
+	if (World != nullptr)
+	{
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+	}
+}
+
+void BlendAreaCommandletUtils::GatherBlendAreas(UWorld* World, TArray<ABlendArea*>& OutBlendAreas)
+{
+	OutBlendAreas.Reset();
+
+	for (TActorIterator<ABlendArea> It(World); It; ++It)
+	{
+		ABlendArea* BlendArea = *It;
+		BlendArea->InitializeArea();
+		OutBlendAreas.Add(BlendArea);
+	}
+}
+
+double BlendAreaCommandletUtils::GetPercentile(const TArray<double>& SortedValues, const double Percentile)
+{
+	if (SortedValues.Num() == 0)
+	{
+		return 0.0;
+	}
+
+	const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile / 100.0 * SortedValues.Num()) - 1, 0, SortedValues.Num() - 1);
+	return SortedValues[Index];
+}
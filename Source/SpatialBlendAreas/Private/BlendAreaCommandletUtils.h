@@ -0,0 +1,31 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ABlendArea;
+
+/** Helpers shared by the headless blend area commandlets. */
+namespace BlendAreaCommandletUtils
+{
+	/** Loads and initializes a map for headless use. Returns nullptr on failure. */
+	UWorld* LoadWorld(const FString& MapName);
+
+	/** Releases a world returned by LoadWorld(). */
+	void UnloadWorld(UWorld* World);
+
+	/** Collects and initializes every blend area in the world. */
+	void GatherBlendAreas(UWorld* World, TArray<ABlendArea*>& OutBlendAreas);
+
+	/** Returns the value at the given percentile (0-100) of an array sorted in ascending order. */
+	double GetPercentile(const TArray<double>& SortedValues, const double Percentile);
+}
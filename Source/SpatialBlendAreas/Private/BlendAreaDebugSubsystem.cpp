@@ -0,0 +1,124 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendAreaDebugSubsystem.h"
+#include "Components/LineBatchComponent.h"
+#include "Engine/World.h"
+#include "WorldArea.h"
+
+bool UBlendAreaDebugSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if WITH_EDITOR
+	return Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+void UBlendAreaDebugSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	GeometryChangedHandle = AWorldArea::OnGeometryChanged.AddUObject(this, &UBlendAreaDebugSubsystem::OnAreaGeometryChanged);
+}
+
+void UBlendAreaDebugSubsystem::Deinitialize()
+{
+	AWorldArea::OnGeometryChanged.Remove(GeometryChangedHandle);
+
+	if (LineBatcher != nullptr)
+	{
+		LineBatcher->Flush();
+		LineBatcher->UnregisterComponent();
+		LineBatcher = nullptr;
+	}
+
+	Areas.Reset();
+	Super::Deinitialize();
+}
+
+TStatId UBlendAreaDebugSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBlendAreaDebugSubsystem, STATGROUP_Tickables);
+}
+
+void UBlendAreaDebugSubsystem::RegisterArea(AWorldArea* Area)
+{
+	Areas.AddUnique(Area);
+	MarkDirty();
+}
+
+void UBlendAreaDebugSubsystem::UnregisterArea(AWorldArea* Area)
+{
+	Areas.Remove(Area);
+	MarkDirty();
+}
+
+void UBlendAreaDebugSubsystem::OnAreaGeometryChanged(AWorldArea* Area)
+{
+	if (Areas.Contains(Area))
+	{
+		MarkDirty();
+	}
+}
+
+void UBlendAreaDebugSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if WITH_EDITOR
+	if (bIsDirty)
+	{
+		RebuildLineBatch();
+	}
+
+	for (const auto& Area : Areas)
+	{
+		if (Area.IsValid() && Area->HasDynamicDebugDraw())
+		{
+			Area->DrawDynamicDebug();
+		}
+	}
+#endif
+}
+
+void UBlendAreaDebugSubsystem::RebuildLineBatch()
+{
+#if WITH_EDITOR
+	bIsDirty = false;
+	UWorld* World = GetWorld();
+
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	if (LineBatcher == nullptr)
+	{
+		LineBatcher = NewObject<ULineBatchComponent>(this);
+		LineBatcher->bCalculateAccurateBounds = false;
+		LineBatcher->RegisterComponentWithWorld(World);
+	}
+
+	// Lines and points with zero lifetime persist until the next flush.
+	TArray<FBatchedLine> Lines;
+	TArray<FBatchedPoint> Points;
+	Areas.RemoveAll([](const TWeakObjectPtr<AWorldArea>& Area) { return !Area.IsValid(); });
+
+	for (const auto& Area : Areas)
+	{
+		Area->AppendDebugLines(Lines, Points);
+	}
+
+	LineBatcher->Flush();
+	LineBatcher->DrawLines(Lines);
+	LineBatcher->BatchedPoints.Append(MoveTemp(Points));
+	LineBatcher->MarkRenderStateDirty();
+#endif
+}
@@ -0,0 +1,34 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+
+#include "BlendAreaKernels.h"
+
+EBlendAreaKind BlendAreaKernels::GetKind(const ABlendArea* Area)
+{
+	const UClass* NativeClass = Area != nullptr ? Area->GetClass() : nullptr;
+
+	while (NativeClass != nullptr && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+
+	if (NativeClass == AHorizontalBlendArea::StaticClass())
+	{
+		return EBlendAreaKind::Horizontal;
+	}
+
+	if (NativeClass == AVerticalBlendArea::StaticClass())
+	{
+		return EBlendAreaKind::Vertical;
+	}
+
+	return EBlendAreaKind::Custom;
+}
@@ -0,0 +1,327 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendAreaProfileCommandlet.h"
+#include "BlendAreaCommandletUtils.h"
+#include "BlendArea.h"
+#include "BlendAreaSubsystem.h"
+#include "BlendWeightDistributor.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	struct FAreaProfile
+	{
+		int32 OverlappingBounds = 0;
+		int32 NestingDepth = 0;
+		double IsInsideNs[2] = { 0.0, 0.0 };
+		double BlendWeightNs[2] = { 0.0, 0.0 };
+
+		/** IsInside() followed by GetClosestPointAndDistanceSquared(), versus the fused GetSignedDistance(). */
+		double TwoPassDistanceNs[2] = { 0.0, 0.0 };
+		double FusedDistanceNs[2] = { 0.0, 0.0 };
+	};
+
+	/** An area is considered nested inside another if all of its vertices are inside the other polygon. */
+	bool IsNestedInside(const ABlendArea* Inner, const ABlendArea* Outer)
+	{
+		if (!Outer->GetBounds().IsInside(Inner->GetBounds()))
+		{
+			return false;
+		}
+
+		for (const FVector2D& Point : Inner->GetPoints())
+		{
+			if (!Outer->IsInside(Point))
+			{
+				return false;
+			}
+		}
+
+		return Inner->GetPoints().Num() > 0;
+	}
+
+	double TimeQueriesNs(const TArray<FVector>& Queries, TFunctionRef<void(const FVector&)> Query)
+	{
+		if (Queries.Num() == 0)
+		{
+			return 0.0;
+		}
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		for (const FVector& Position : Queries)
+		{
+			Query(Position);
+		}
+
+		return FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000000.0 / Queries.Num();
+	}
+}
+
+UBlendAreaProfileCommandlet::UBlendAreaProfileCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UBlendAreaProfileCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=BlendAreaProfile -Map=<map> [-Csv=<file>] [-RandomQueries=<count>] [-GridSize=<count>] [-Seed=<seed>] [-Z=<height>] [-BudgetNs=<ns>]"))
+		return 1;
+	}
+
+	FString CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Profiling"), TEXT("BlendAreaProfile.csv"));
+	int32 RandomQueryCount = 10000;
+	int32 GridSize = 100;
+	int32 Seed = 0;
+	double QueryHeight = 0.0;
+	double BudgetNs = 0.0;
+
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+	FParse::Value(*Params, TEXT("RandomQueries="), RandomQueryCount);
+	FParse::Value(*Params, TEXT("GridSize="), GridSize);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Z="), QueryHeight);
+	FParse::Value(*Params, TEXT("BudgetNs="), BudgetNs);
+
+	UWorld* World = BlendAreaCommandletUtils::LoadWorld(MapName);
+
+	if (World == nullptr)
+	{
+		return 1;
+	}
+
+	TArray<ABlendArea*> BlendAreas;
+	BlendAreaCommandletUtils::GatherBlendAreas(World, BlendAreas);
+
+	if (BlendAreas.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No blend areas found in '%s'."), *MapName)
+		BlendAreaCommandletUtils::UnloadWorld(World);
+		return 0;
+	}
+
+	TArray<FAreaProfile> Profiles;
+	Profiles.SetNum(BlendAreas.Num());
+	FBox2D WorldBounds(ForceInit);
+	int32 OverlappingPairs = 0;
+	int32 TotalVertices = 0;
+
+	for (int32 IndexA = 0; IndexA < BlendAreas.Num(); IndexA++)
+	{
+		const ABlendArea* AreaA = BlendAreas[IndexA];
+		WorldBounds += AreaA->GetBounds();
+		TotalVertices += AreaA->GetPoints().Num();
+
+		for (int32 IndexB = 0; IndexB < BlendAreas.Num(); IndexB++)
+		{
+			const ABlendArea* AreaB = BlendAreas[IndexB];
+
+			if (IndexA == IndexB)
+			{
+				continue;
+			}
+
+			if (AreaA->GetBounds().Intersect(AreaB->GetBounds()))
+			{
+				Profiles[IndexA].OverlappingBounds++;
+				OverlappingPairs += IndexA < IndexB ? 1 : 0;
+			}
+
+			if (IsNestedInside(AreaA, AreaB))
+			{
+				Profiles[IndexA].NestingDepth++;
+			}
+		}
+	}
+
+	// Sweep 0 is uniformly random, sweep 1 a regular grid, both covering the combined bounds of all areas.
+	TArray<FVector> Sweeps[2];
+	FRandomStream RandomStream(Seed);
+	Sweeps[0].Reserve(RandomQueryCount);
+
+	for (int32 Index = 0; Index < RandomQueryCount; Index++)
+	{
+		Sweeps[0].Emplace(RandomStream.FRandRange(WorldBounds.Min.X, WorldBounds.Max.X),
+						  RandomStream.FRandRange(WorldBounds.Min.Y, WorldBounds.Max.Y), QueryHeight);
+	}
+
+	GridSize = FMath::Max(GridSize, 1);
+	Sweeps[1].Reserve(GridSize * GridSize);
+	const FVector2D CellSize = WorldBounds.GetSize() / GridSize;
+
+	for (int32 Y = 0; Y < GridSize; Y++)
+	{
+		for (int32 X = 0; X < GridSize; X++)
+		{
+			const FVector2D Position = WorldBounds.Min + CellSize * FVector2D(X + 0.5, Y + 0.5);
+			Sweeps[1].Emplace(Position.X, Position.Y, QueryHeight);
+		}
+	}
+
+	// Accumulated into a volatile sink, so that the compiler cannot drop the measured calls.
+	volatile float ResultSink = 0.f;
+	double DistributionNs[2] = { 0.0, 0.0 };
+	double SharedDistributionNs[2] = { 0.0, 0.0 };
+
+	for (int32 Sweep = 0; Sweep < 2; Sweep++)
+	{
+		for (int32 Index = 0; Index < BlendAreas.Num(); Index++)
+		{
+			const ABlendArea* BlendArea = BlendAreas[Index];
+
+			Profiles[Index].IsInsideNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+			{
+				ResultSink = ResultSink + (BlendArea->IsInside(Position) ? 1.f : 0.f);
+			});
+
+			Profiles[Index].BlendWeightNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+			{
+				ResultSink = ResultSink + BlendArea->GetBlendWeight(Position);
+			});
+
+			Profiles[Index].TwoPassDistanceNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+			{
+				const FVector2D Position2D = FVector2D(Position.X, Position.Y);
+				FVector2D ClosestPoint;
+				double DistanceSquared = 0.0;
+				const bool bIsInside = BlendArea->IsInside(Position2D);
+				BlendArea->GetClosestPointAndDistanceSquared(Position2D, ClosestPoint, DistanceSquared);
+				ResultSink = ResultSink + static_cast<float>(bIsInside ? -DistanceSquared : DistanceSquared);
+			});
+
+			Profiles[Index].FusedDistanceNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+			{
+				FWorldAreaSignedDistance Distance;
+				BlendArea->GetSignedDistance(FVector2D(Position.X, Position.Y), Distance);
+				ResultSink = ResultSink + static_cast<float>(Distance.bIsInside ? -Distance.DistanceSquared : Distance.DistanceSquared);
+			});
+		}
+	}
+
+	TSet<const ABlendArea*> Registrees;
+
+	for (const ABlendArea* BlendArea : BlendAreas)
+	{
+		Registrees.Add(BlendArea);
+	}
+
+	UBlendWeightDistributor* Distributor = NewObject<UBlendWeightDistributor>();
+	Distributor->Initialize(Registrees);
+
+	for (int32 Sweep = 0; Sweep < 2; Sweep++)
+	{
+		DistributionNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+		{
+			Distributor->UpdateWeightData(Position);
+		});
+	}
+
+	// The same distribution through the arrangement grid of the subsystem. Registering the areas and refreshing
+	// each of them once measure the cost of indexing a streamed-in area and of an area edited during play.
+	double RegisterMs = 0.0;
+	double RefreshMs = 0.0;
+
+	if (UBlendAreaSubsystem* Subsystem = UWorld::GetSubsystem<UBlendAreaSubsystem>(World))
+	{
+		const uint64 RegisterStartCycles = FPlatformTime::Cycles64();
+
+		for (const ABlendArea* BlendArea : BlendAreas)
+		{
+			Subsystem->RegisterArea(BlendArea);
+		}
+
+		RegisterMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - RegisterStartCycles);
+		const uint64 RefreshStartCycles = FPlatformTime::Cycles64();
+
+		for (const ABlendArea* BlendArea : BlendAreas)
+		{
+			Subsystem->RefreshArea(BlendArea);
+		}
+
+		RefreshMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - RefreshStartCycles);
+
+		UBlendWeightDistributor* SharedDistributor = NewObject<UBlendWeightDistributor>();
+		SharedDistributor->Initialize(Registrees, Subsystem);
+
+		for (int32 Sweep = 0; Sweep < 2; Sweep++)
+		{
+			SharedDistributionNs[Sweep] = TimeQueriesNs(Sweeps[Sweep], [&](const FVector& Position)
+			{
+				// Every query stands for a frame of its own, so none of them is answered from the weight cache.
+				Subsystem->InvalidateCache();
+				SharedDistributor->UpdateWeightData(Position);
+			});
+		}
+	}
+
+	FString Csv = TEXT("Area,Class,Vertices,OverlappingBounds,NestingDepth,IsInsideRandomNs,GetBlendWeightRandomNs,IsInsideGridNs,GetBlendWeightGridNs,")
+				  TEXT("TwoPassDistanceRandomNs,FusedDistanceRandomNs,TwoPassDistanceGridNs,FusedDistanceGridNs,DistributionRandomNs,DistributionGridNs,")
+				  TEXT("SharedDistributionRandomNs,SharedDistributionGridNs\n");
+	double Totals[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+	for (int32 Index = 0; Index < BlendAreas.Num(); Index++)
+	{
+		const ABlendArea* BlendArea = BlendAreas[Index];
+		const FAreaProfile& Profile = Profiles[Index];
+
+		Csv += FString::Printf(TEXT("%s,%s,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,,,,\n"), *BlendArea->GetFName().ToString(), *BlendArea->GetClass()->GetName(),
+							   BlendArea->GetPoints().Num(), Profile.OverlappingBounds, Profile.NestingDepth,
+							   Profile.IsInsideNs[0], Profile.BlendWeightNs[0], Profile.IsInsideNs[1], Profile.BlendWeightNs[1],
+							   Profile.TwoPassDistanceNs[0], Profile.FusedDistanceNs[0], Profile.TwoPassDistanceNs[1], Profile.FusedDistanceNs[1]);
+
+		Totals[0] += Profile.IsInsideNs[0];
+		Totals[1] += Profile.BlendWeightNs[0];
+		Totals[2] += Profile.IsInsideNs[1];
+		Totals[3] += Profile.BlendWeightNs[1];
+		Totals[4] += Profile.TwoPassDistanceNs[0];
+		Totals[5] += Profile.FusedDistanceNs[0];
+		Totals[6] += Profile.TwoPassDistanceNs[1];
+		Totals[7] += Profile.FusedDistanceNs[1];
+	}
+
+	Csv += FString::Printf(TEXT("Total,,%d,%d,,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n"), TotalVertices, OverlappingPairs,
+						   Totals[0], Totals[1], Totals[2], Totals[3], Totals[4], Totals[5], Totals[6], Totals[7], DistributionNs[0], DistributionNs[1],
+						   SharedDistributionNs[0], SharedDistributionNs[1]);
+
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not write '%s'."), *CsvPath)
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Profiled %d blend areas (%d vertices, %d overlapping bounds pairs) in '%s'."),
+		   BlendAreas.Num(), TotalVertices, OverlappingPairs, *MapName)
+	UE_LOG(LogTemp, Display, TEXT("Full distribution: %.1f ns/query (random), %.1f ns/query (grid). Results written to '%s'."),
+		   DistributionNs[0], DistributionNs[1], *CsvPath)
+	UE_LOG(LogTemp, Display, TEXT("Distribution through the arrangement grid: %.1f ns/query (random), %.1f ns/query (grid). Indexing all areas took %.2f ms, refreshing each once %.2f ms."),
+		   SharedDistributionNs[0], SharedDistributionNs[1], RegisterMs, RefreshMs)
+	UE_LOG(LogTemp, Display, TEXT("Containment and boundary distance, all areas: two-pass %.1f / %.1f ns/query, fused %.1f / %.1f ns/query (random / grid)."),
+		   Totals[4], Totals[6], Totals[5], Totals[7])
+
+	BlendAreaCommandletUtils::UnloadWorld(World);
+
+	const double WorstDistributionNs = FMath::Max(DistributionNs[0], DistributionNs[1]);
+
+	if (BudgetNs > 0.0 && WorstDistributionNs > BudgetNs)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Full distribution costs %.1f ns/query, which exceeds the budget of %.1f ns/query."), WorstDistributionNs, BudgetNs)
+		return 1;
+	}
+
+	return 0;
+}
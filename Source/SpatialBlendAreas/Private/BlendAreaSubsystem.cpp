@@ -0,0 +1,753 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendAreaSubsystem.h"
+#include "BlendArea.h"
+#include "Algo/Sort.h"
+#include "Algo/StableSort.h"
+#include "Async/ParallelFor.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarArrangementCellSize(
+	TEXT("SpatialBlendAreas.ArrangementCellSize"),
+	1000.f,
+	TEXT("The cell size of the finest level of the blend area arrangement grid in world units. Takes effect in worlds created after the change."));
+
+static TAutoConsoleVariable<bool> CVarParallelAreaInitialization(
+	TEXT("SpatialBlendAreas.ParallelAreaInitialization"),
+	true,
+	TEXT("Initializes the world areas present at the start of play on worker threads. When disabled, they are initialized serially."));
+
+namespace BlendAreaSubsystem
+{
+	/** Weight cache markers for candidates that have not been evaluated yet. */
+	constexpr float NotEvaluated = -1.f;
+	constexpr float NotEvaluatedContained = -2.f;
+
+	FIntPoint ToCell(const FVector2D& Point, const double CellSize)
+	{
+		return FIntPoint(FMath::FloorToInt(Point.X / CellSize), FMath::FloorToInt(Point.Y / CellSize));
+	}
+}
+
+void UBlendAreaSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	GeometryChangedHandle = AWorldArea::OnGeometryChanged.AddUObject(this, &UBlendAreaSubsystem::OnAreaGeometryChanged);
+
+	// The cells are anchored at the world origin and never resized, so the cell size is fixed for the lifetime of the world.
+	GridCellSize = FMath::Max<double>(CVarArrangementCellSize.GetValueOnGameThread(), 1.0);
+	GridLevels.SetNum(MaxGridLevels);
+	ResetCache();
+}
+
+void UBlendAreaSubsystem::Deinitialize()
+{
+	AWorldArea::OnGeometryChanged.Remove(GeometryChangedHandle);
+	Areas.Reset();
+	AreaIndices.Reset();
+	AreaKinds.Reset();
+	AreaEntries.Reset();
+	FreeAreaIndices.Reset();
+	GridLevels.Reset();
+	TreeNodes.Reset();
+	ResetCache();
+	Super::Deinitialize();
+}
+
+void UBlendAreaSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Runs before any actor begins play, so the areas find themselves initialized in their BeginPlay.
+	TArray<AWorldArea*> WorldAreas;
+
+	for (TActorIterator<AWorldArea> It(&InWorld); It; ++It)
+	{
+		WorldAreas.Add(*It);
+	}
+
+	if (WorldAreas.Num() == 0)
+	{
+		return;
+	}
+
+	InitializeAreas(WorldAreas);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	for (const AWorldArea* WorldArea : WorldAreas)
+	{
+		if (const ABlendArea* BlendArea = Cast<ABlendArea>(WorldArea))
+		{
+			RegisterArea(BlendArea);
+		}
+	}
+
+	// The areas were inserted into the bounds tree one by one; rebuild it balanced now that they are all known.
+	BuildTree();
+
+	UE_LOG(LogTemp, Log, TEXT("Indexed %d blend areas in %.2f ms."), AreaIndices.Num(),
+		   FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles))
+}
+
+void UBlendAreaSubsystem::InitializeAreas(TArrayView<AWorldArea* const> WorldAreas)
+{
+	TArray<double> AreaMilliseconds;
+	AreaMilliseconds.SetNumZeroed(WorldAreas.Num());
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	// The areas only read their own components and write their own geometry, so they can be built independently.
+	ParallelFor(WorldAreas.Num(), [&WorldAreas, &AreaMilliseconds](const int32 Index)
+	{
+		const uint64 AreaStartCycles = FPlatformTime::Cycles64();
+		WorldAreas[Index]->InitializeAreaForPlay();
+		AreaMilliseconds[Index] = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - AreaStartCycles);
+	}, !CVarParallelAreaInitialization.GetValueOnGameThread());
+
+	const double TotalMilliseconds = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+	UE_LOG(LogTemp, Log, TEXT("Initialized %d world areas in %.2f ms (%s)."), WorldAreas.Num(), TotalMilliseconds,
+		   CVarParallelAreaInitialization.GetValueOnGameThread() ? TEXT("parallel") : TEXT("serial"))
+
+	TArray<int32> SlowestAreas;
+	SlowestAreas.Reserve(WorldAreas.Num());
+
+	for (int32 Index = 0; Index < WorldAreas.Num(); Index++)
+	{
+		SlowestAreas.Add(Index);
+	}
+
+	Algo::SortBy(SlowestAreas, [&AreaMilliseconds](const int32 Index) { return AreaMilliseconds[Index]; }, TGreater<>());
+
+	for (int32 Rank = 0; Rank < FMath::Min(SlowestAreas.Num(), SlowestAreasToLog); Rank++)
+	{
+		const AWorldArea* WorldArea = WorldAreas[SlowestAreas[Rank]];
+
+		UE_LOG(LogTemp, Log, TEXT("  %.3f ms: '%s' (%d vertices, %d rings)"), AreaMilliseconds[SlowestAreas[Rank]],
+			   *WorldArea->GetName(), WorldArea->GetPoints().Num(), WorldArea->GetRingCount())
+	}
+}
+
+int32 UBlendAreaSubsystem::RegisterArea(const ABlendArea* BlendArea)
+{
+	if (!IsValid(BlendArea))
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* Index = AreaIndices.Find(BlendArea))
+	{
+		// Managers register their areas before the world initializes them, when there are no bounds to index yet.
+		if (AreaEntries[*Index].GridLevel == INDEX_NONE && BlendArea->GetBounds().bIsValid)
+		{
+			AddToGrid(*Index);
+			RemoveFromTree(*Index);
+			AddToTree(*Index);
+			ResetCache();
+		}
+
+		return *Index;
+	}
+
+	int32 Index = INDEX_NONE;
+
+	if (FreeAreaIndices.Num() > 0)
+	{
+		Index = FreeAreaIndices.Pop(false);
+		Areas[Index] = BlendArea;
+		AreaKinds[Index] = BlendAreaKernels::GetKind(BlendArea);
+		AreaEntries[Index] = FAreaEntry();
+	}
+	else
+	{
+		Index = Areas.Add(BlendArea);
+		AreaKinds.Add(BlendAreaKernels::GetKind(BlendArea));
+		AreaEntries.AddDefaulted();
+	}
+
+	AreaIndices.Add(BlendArea, Index);
+	AddToGrid(Index);
+	AddToTree(Index);
+
+	// The cache is laid out by area count, so any weights gathered this frame are simply dropped.
+	ResetCache();
+	return Index;
+}
+
+void UBlendAreaSubsystem::UnregisterArea(const ABlendArea* BlendArea)
+{
+	int32 Index = INDEX_NONE;
+
+	if (!AreaIndices.RemoveAndCopyValue(BlendArea, Index))
+	{
+		return;
+	}
+
+	RemoveFromGrid(Index);
+	RemoveFromTree(Index);
+	Areas[Index].Reset();
+	FreeAreaIndices.Add(Index);
+	ResetCache();
+}
+
+void UBlendAreaSubsystem::RefreshArea(const ABlendArea* BlendArea)
+{
+	const int32* Index = AreaIndices.Find(BlendArea);
+
+	if (Index == nullptr)
+	{
+		return;
+	}
+
+	// The entry of the area still describes where it was indexed, so only the cells and leaves of its old and new bounds are touched.
+	RemoveFromGrid(*Index);
+	AddToGrid(*Index);
+	RemoveFromTree(*Index);
+	AddToTree(*Index);
+	ResetCache();
+}
+
+int32 UBlendAreaSubsystem::GetAreaIndex(const ABlendArea* BlendArea) const
+{
+	const int32* Index = AreaIndices.Find(BlendArea);
+	return Index != nullptr ? *Index : INDEX_NONE;
+}
+
+int32 UBlendAreaSubsystem::FindOrAddPosition(const FVector& Position)
+{
+	if (CacheFrame != GFrameCounter)
+	{
+		ResetCache();
+		CacheFrame = GFrameCounter;
+	}
+
+	// Managers following the same listener pass bitwise identical positions, so an exact match is enough.
+	for (int32 Slot = 0; Slot < CachedPositions.Num(); Slot++)
+	{
+		if (CachedPositions[Slot] == Position)
+		{
+			return Slot;
+		}
+	}
+
+	const int32 FirstCandidate = CachedCandidates.Num();
+	GatherCandidates(FVector2D(Position.X, Position.Y), CachedCandidates);
+	CachedCandidateOffsets.Add(CachedCandidates.Num());
+
+	// Every area outside the candidates of the cells has a zero weight without evaluating it.
+	CachedWeights.AddZeroed(Areas.Num());
+	float* SlotWeights = CachedWeights.GetData() + CachedPositions.Num() * Areas.Num();
+
+	for (int32 Index = FirstCandidate; Index < CachedCandidates.Num(); Index++)
+	{
+		const FBlendAreaCandidate& Candidate = CachedCandidates[Index];
+		SlotWeights[Candidate.AreaIndex] = Candidate.bContainsCell ? BlendAreaSubsystem::NotEvaluatedContained : BlendAreaSubsystem::NotEvaluated;
+	}
+
+	return CachedPositions.Add(Position);
+}
+
+TArrayView<const FBlendAreaCandidate> UBlendAreaSubsystem::FindCandidates(const FVector2D& Point)
+{
+	CandidateScratch.Reset();
+	GatherCandidates(Point, CandidateScratch);
+	return CandidateScratch;
+}
+
+void UBlendAreaSubsystem::GatherCandidates(const FVector2D& Point, TArray<FBlendAreaCandidate>& OutCandidates) const
+{
+	const int32 FirstCandidate = OutCandidates.Num();
+	int32 ContributingLevels = 0;
+	double CellSize = GridCellSize;
+
+	for (const FGridLevel& Level : GridLevels)
+	{
+		if (Level.AreaCount > 0)
+		{
+			if (const FGridCell* Cell = Level.Cells.Find(BlendAreaSubsystem::ToCell(Point, CellSize)))
+			{
+				OutCandidates.Append(Cell->Candidates);
+				ContributingLevels++;
+			}
+		}
+
+		CellSize *= 2.0;
+	}
+
+	// Each cell is sorted already; only candidates merged from several levels need sorting.
+	if (ContributingLevels > 1)
+	{
+		Algo::StableSortBy(MakeArrayView(OutCandidates.GetData() + FirstCandidate, OutCandidates.Num() - FirstCandidate),
+						   [](const FBlendAreaCandidate& Candidate) { return Candidate.Priority; }, TGreater<uint32>());
+	}
+}
+
+void UBlendAreaSubsystem::AddToGrid(const int32 AreaIndex)
+{
+	const ABlendArea* Area = Areas[AreaIndex].Get();
+	FAreaEntry& Entry = AreaEntries[AreaIndex];
+	Entry.GridLevel = INDEX_NONE;
+
+	if (Area == nullptr || !Area->GetBounds().bIsValid)
+	{
+		return;
+	}
+
+	// Place the area on the finest level where it spans at most MaxCellsPerAxis cells per axis.
+	const FBox2D& Bounds = Area->GetBounds();
+	double CellSize = GridCellSize;
+	int32 LevelIndex = 0;
+
+	for (;; LevelIndex++, CellSize *= 2.0)
+	{
+		Entry.MinCell = BlendAreaSubsystem::ToCell(Bounds.Min, CellSize);
+		Entry.MaxCell = BlendAreaSubsystem::ToCell(Bounds.Max, CellSize);
+
+		const FIntPoint Span = Entry.MaxCell - Entry.MinCell;
+
+		if (FMath::Max(Span.X, Span.Y) < MaxCellsPerAxis || LevelIndex == MaxGridLevels - 1)
+		{
+			break;
+		}
+	}
+
+	Entry.GridLevel = LevelIndex;
+	FGridLevel& Level = GridLevels[LevelIndex];
+	Level.AreaCount++;
+
+	const FIntPoint MinCell = Entry.MinCell;
+	const FIntPoint MaxCell = Entry.MaxCell;
+	const int32 Columns = MaxCell.X - MinCell.X + 1;
+
+	// Mark the cells the boundary may pass through. Within any other cell, the area either contains every point or none.
+	BoundaryCells.Init(false, Columns * (MaxCell.Y - MinCell.Y + 1));
+
+	Area->ForEachEdge([&](const FVector2D& Start, const FVector2D& End)
+	{
+		const FIntPoint EdgeMin = BlendAreaSubsystem::ToCell(FVector2D(FMath::Min(Start.X, End.X), FMath::Min(Start.Y, End.Y)), CellSize);
+		const FIntPoint EdgeMax = BlendAreaSubsystem::ToCell(FVector2D(FMath::Max(Start.X, End.X), FMath::Max(Start.Y, End.Y)), CellSize);
+
+		for (int32 Y = FMath::Max(EdgeMin.Y, MinCell.Y); Y <= FMath::Min(EdgeMax.Y, MaxCell.Y); Y++)
+		{
+			for (int32 X = FMath::Max(EdgeMin.X, MinCell.X); X <= FMath::Min(EdgeMax.X, MaxCell.X); X++)
+			{
+				BoundaryCells[(Y - MinCell.Y) * Columns + (X - MinCell.X)] = true;
+			}
+		}
+	});
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			FBlendAreaCandidate Candidate;
+			Candidate.AreaIndex = AreaIndex;
+			Candidate.Priority = Area->Priority;
+
+			if (!BoundaryCells[(Y - MinCell.Y) * Columns + (X - MinCell.X)])
+			{
+				const FVector2D CellCenter = (FVector2D(X, Y) + 0.5) * CellSize;
+
+				if (!Area->IsInside(CellCenter))
+				{
+					continue;
+				}
+
+				Candidate.bContainsCell = true;
+			}
+
+			// Insert after the candidates of equal or higher priority, keeping the cell in the order the distributor consumes it.
+			TArray<FBlendAreaCandidate, TInlineAllocator<4>>& Candidates = Level.Cells.FindOrAdd(FIntPoint(X, Y)).Candidates;
+			const int32 InsertIndex = Candidates.IndexOfByPredicate([&Candidate](const FBlendAreaCandidate& Other) { return Other.Priority < Candidate.Priority; });
+			Candidates.Insert(Candidate, InsertIndex != INDEX_NONE ? InsertIndex : Candidates.Num());
+		}
+	}
+}
+
+void UBlendAreaSubsystem::RemoveFromGrid(const int32 AreaIndex)
+{
+	FAreaEntry& Entry = AreaEntries[AreaIndex];
+
+	if (Entry.GridLevel == INDEX_NONE)
+	{
+		return;
+	}
+
+	FGridLevel& Level = GridLevels[Entry.GridLevel];
+	Level.AreaCount--;
+
+	for (int32 Y = Entry.MinCell.Y; Y <= Entry.MaxCell.Y; Y++)
+	{
+		for (int32 X = Entry.MinCell.X; X <= Entry.MaxCell.X; X++)
+		{
+			const FIntPoint CellKey(X, Y);
+			FGridCell* Cell = Level.Cells.Find(CellKey);
+
+			if (Cell == nullptr)
+			{
+				continue;
+			}
+
+			Cell->Candidates.RemoveAll([AreaIndex](const FBlendAreaCandidate& Candidate) { return Candidate.AreaIndex == AreaIndex; });
+
+			if (Cell->Candidates.Num() == 0)
+			{
+				Level.Cells.Remove(CellKey);
+			}
+		}
+	}
+
+	Entry.GridLevel = INDEX_NONE;
+}
+
+float UBlendAreaSubsystem::GetBlendWeight(const int32 AreaIndex, const int32 PositionSlot)
+{
+	check(CachedPositions.IsValidIndex(PositionSlot) && Areas.IsValidIndex(AreaIndex));
+
+	float& Weight = CachedWeights[PositionSlot * Areas.Num() + AreaIndex];
+
+	if (Weight < 0.f)
+	{
+		const ABlendArea* Area = Areas[AreaIndex].Get();
+
+		if (Area == nullptr)
+		{
+			Weight = 0.f;
+		}
+		else if (Weight == BlendAreaSubsystem::NotEvaluatedContained)
+		{
+			Weight = BlendAreaKernels::GetBlendWeightContained(AreaKinds[AreaIndex], *Area, CachedPositions[PositionSlot]);
+		}
+		else
+		{
+			Weight = BlendAreaKernels::GetBlendWeight(AreaKinds[AreaIndex], *Area, CachedPositions[PositionSlot]);
+		}
+	}
+
+	return Weight;
+}
+
+void UBlendAreaSubsystem::OnAreaGeometryChanged(AWorldArea* Area)
+{
+	// The delegate is shared by all worlds, e.g. the editor world and the PIE worlds.
+	if (Area == nullptr || Area->GetWorld() != GetWorld())
+	{
+		return;
+	}
+
+	RefreshArea(Cast<ABlendArea>(Area));
+}
+
+void UBlendAreaSubsystem::InvalidateCache()
+{
+	ResetCache();
+	CacheFrame = GFrameCounter;
+}
+
+void UBlendAreaSubsystem::ResetCache()
+{
+	CachedPositions.Reset();
+	CachedCandidates.Reset();
+	CachedCandidateOffsets.Reset();
+	CachedCandidateOffsets.Add(0);
+	CachedWeights.Reset();
+}
+
+void UBlendAreaSubsystem::FindAreasInRadius(const FVector2D& Point, const double Radius, TArray<FBlendAreaDistance>& OutAreas)
+{
+	FindAreas(Point, MAX_int32, FMath::Max(Radius, 0.0), OutAreas);
+}
+
+void UBlendAreaSubsystem::FindNearestAreas(const FVector2D& Point, const int32 Count, TArray<FBlendAreaDistance>& OutAreas)
+{
+	FindAreas(Point, Count, TNumericLimits<double>::Max(), OutAreas);
+}
+
+void UBlendAreaSubsystem::FindAreas(const FVector2D& Point, const int32 MaxCount, const double MaxDistance, TArray<FBlendAreaDistance>& OutAreas)
+{
+	OutAreas.Reset();
+
+	// The root of a tree whose areas have all been removed is left with invalid bounds.
+	if (TreeNodes.Num() == 0 || !TreeNodes[0].Bounds.bIsValid || MaxCount <= 0)
+	{
+		return;
+	}
+
+	struct FPendingNode
+	{
+		int32 Node;
+		double DistanceSquared;
+	};
+
+	auto IsCloser = [](const FPendingNode& A, const FPendingNode& B) { return A.DistanceSquared < B.DistanceSquared; };
+	auto IsResultCloser = [](const FBlendAreaDistance& A, const FBlendAreaDistance& B) { return A.Distance < B.Distance; };
+
+	// Squared distances are compared against this bound, which shrinks to the farthest kept result once 'MaxCount' are found.
+	double BoundSquared = MaxDistance < TNumericLimits<double>::Max() ? FMath::Square(MaxDistance) : MaxDistance;
+
+	TArray<FPendingNode, TInlineAllocator<64>> PendingNodes;
+	PendingNodes.HeapPush({ 0, TreeNodes[0].Bounds.ComputeSquaredDistanceToPoint(Point) }, IsCloser);
+
+	while (PendingNodes.Num() > 0)
+	{
+		FPendingNode Pending;
+		PendingNodes.HeapPop(Pending, IsCloser, false);
+
+		// The nodes come closest first, so once one is out of bounds all the rest are too.
+		if (Pending.DistanceSquared > BoundSquared)
+		{
+			break;
+		}
+
+		const FBoundsTreeNode& Node = TreeNodes[Pending.Node];
+
+		if (Node.Children[0] != INDEX_NONE)
+		{
+			for (const int32 Child : Node.Children)
+			{
+				if (!TreeNodes[Child].Bounds.bIsValid)
+				{
+					continue;
+				}
+
+				const double ChildDistanceSquared = TreeNodes[Child].Bounds.ComputeSquaredDistanceToPoint(Point);
+
+				if (ChildDistanceSquared <= BoundSquared)
+				{
+					PendingNodes.HeapPush({ Child, ChildDistanceSquared }, IsCloser);
+				}
+			}
+
+			continue;
+		}
+
+		for (const int32 AreaIndex : Node.Areas)
+		{
+			const ABlendArea* Area = Areas[AreaIndex].Get();
+
+			if (Area == nullptr || Area->GetBounds().ComputeSquaredDistanceToPoint(Point) > BoundSquared)
+			{
+				continue;
+			}
+
+			FBlendAreaDistance Result;
+			Result.Area = Area;
+			double DistanceSquared = 0.0;
+
+			if (Area->IsInside(Point))
+			{
+				Result.ClosestPoint = Point;
+			}
+			else if (!Area->GetClosestPointAndDistanceSquared(Point, BoundSquared, Result.ClosestPoint, DistanceSquared))
+			{
+				continue;
+			}
+
+			Result.Distance = FMath::Sqrt(DistanceSquared);
+			OutAreas.HeapPush(Result, [&IsResultCloser](const FBlendAreaDistance& A, const FBlendAreaDistance& B) { return IsResultCloser(B, A); });
+
+			// Keep the 'MaxCount' closest results in a max-heap, so the farthest one is at the top.
+			if (OutAreas.Num() > MaxCount)
+			{
+				OutAreas.HeapPopDiscard([&IsResultCloser](const FBlendAreaDistance& A, const FBlendAreaDistance& B) { return IsResultCloser(B, A); }, false);
+			}
+
+			if (OutAreas.Num() == MaxCount)
+			{
+				BoundSquared = FMath::Min(BoundSquared, FMath::Square(OutAreas.HeapTop().Distance));
+			}
+		}
+	}
+
+	OutAreas.Sort(IsResultCloser);
+}
+
+void UBlendAreaSubsystem::BuildTree()
+{
+	TreeNodes.Reset();
+	TArray<int32> TreeAreas;
+
+	for (int32 AreaIndex = 0; AreaIndex < Areas.Num(); AreaIndex++)
+	{
+		AreaEntries[AreaIndex].TreeLeaf = INDEX_NONE;
+
+		if (Areas[AreaIndex].IsValid() && Areas[AreaIndex]->GetBounds().bIsValid)
+		{
+			TreeAreas.Add(AreaIndex);
+		}
+	}
+
+	if (TreeAreas.Num() > 0)
+	{
+		TreeNodes.Reserve(2 * TreeAreas.Num() / MaxAreasPerLeaf + 1);
+		BuildTreeNode(TreeAreas, INDEX_NONE);
+	}
+}
+
+int32 UBlendAreaSubsystem::BuildTreeNode(TArrayView<int32> NodeAreas, const int32 Parent)
+{
+	const int32 NodeIndex = TreeNodes.AddDefaulted();
+	FBox2D Bounds(ForceInit);
+
+	for (const int32 AreaIndex : NodeAreas)
+	{
+		Bounds += Areas[AreaIndex]->GetBounds();
+	}
+
+	TreeNodes[NodeIndex].Bounds = Bounds;
+	TreeNodes[NodeIndex].Parent = Parent;
+
+	if (NodeAreas.Num() <= MaxAreasPerLeaf)
+	{
+		TreeNodes[NodeIndex].Areas.Append(NodeAreas.GetData(), NodeAreas.Num());
+
+		for (const int32 AreaIndex : NodeAreas)
+		{
+			AreaEntries[AreaIndex].TreeLeaf = NodeIndex;
+		}
+
+		return NodeIndex;
+	}
+
+	// Split at the median of the area centers along the longer axis of the node.
+	const FVector2D Size = Bounds.GetSize();
+	const int32 Axis = Size.X >= Size.Y ? 0 : 1;
+
+	Algo::SortBy(NodeAreas, [this, Axis](const int32 AreaIndex)
+	{
+		return Areas[AreaIndex]->GetBounds().GetCenter()[Axis];
+	});
+
+	const int32 HalfCount = NodeAreas.Num() / 2;
+	const int32 FirstChild = BuildTreeNode(NodeAreas.Left(HalfCount), NodeIndex);
+	const int32 SecondChild = BuildTreeNode(NodeAreas.RightChop(HalfCount), NodeIndex);
+
+	// The recursion may have reallocated the node array, so index it again instead of holding a reference.
+	TreeNodes[NodeIndex].Children[0] = FirstChild;
+	TreeNodes[NodeIndex].Children[1] = SecondChild;
+	return NodeIndex;
+}
+
+void UBlendAreaSubsystem::AddToTree(const int32 AreaIndex)
+{
+	const ABlendArea* Area = Areas[AreaIndex].Get();
+
+	if (Area == nullptr || !Area->GetBounds().bIsValid)
+	{
+		return;
+	}
+
+	if (TreeNodes.Num() == 0)
+	{
+		TreeNodes.AddDefaulted();
+	}
+
+	const FBox2D& AreaBounds = Area->GetBounds();
+	int32 Node = 0;
+
+	// Descend into the child whose bounds grow the least; a child emptied by removals costs the whole area.
+	while (TreeNodes[Node].Children[0] != INDEX_NONE)
+	{
+		double Costs[2];
+
+		for (int32 Side = 0; Side < 2; Side++)
+		{
+			const FBox2D& ChildBounds = TreeNodes[TreeNodes[Node].Children[Side]].Bounds;
+			Costs[Side] = ChildBounds.bIsValid ? (ChildBounds + AreaBounds).GetArea() - ChildBounds.GetArea() : AreaBounds.GetArea();
+		}
+
+		Node = TreeNodes[Node].Children[Costs[1] < Costs[0] ? 1 : 0];
+	}
+
+	TreeNodes[Node].Areas.Add(AreaIndex);
+	AreaEntries[AreaIndex].TreeLeaf = Node;
+	RefitTree(Node);
+
+	if (TreeNodes[Node].Areas.Num() > 2 * MaxAreasPerLeaf)
+	{
+		SplitLeaf(Node);
+	}
+}
+
+void UBlendAreaSubsystem::RemoveFromTree(const int32 AreaIndex)
+{
+	const int32 Leaf = AreaEntries[AreaIndex].TreeLeaf;
+
+	if (Leaf == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Emptied leaves are kept with invalid bounds and refilled by later insertions; BuildTree() compacts the tree.
+	TreeNodes[Leaf].Areas.RemoveSingleSwap(AreaIndex, false);
+	AreaEntries[AreaIndex].TreeLeaf = INDEX_NONE;
+	RefitTree(Leaf);
+}
+
+void UBlendAreaSubsystem::RefitTree(int32 Node)
+{
+	for (; Node != INDEX_NONE; Node = TreeNodes[Node].Parent)
+	{
+		FBoundsTreeNode& TreeNode = TreeNodes[Node];
+		FBox2D Bounds(ForceInit);
+
+		if (TreeNode.Children[0] != INDEX_NONE)
+		{
+			// Adding an invalid box leaves the bounds unchanged.
+			Bounds += TreeNodes[TreeNode.Children[0]].Bounds;
+			Bounds += TreeNodes[TreeNode.Children[1]].Bounds;
+		}
+		else
+		{
+			for (const int32 AreaIndex : TreeNode.Areas)
+			{
+				if (const ABlendArea* Area = Areas[AreaIndex].Get())
+				{
+					Bounds += Area->GetBounds();
+				}
+			}
+		}
+
+		TreeNode.Bounds = Bounds;
+	}
+}
+
+void UBlendAreaSubsystem::SplitLeaf(const int32 Node)
+{
+	TArray<int32, TInlineAllocator<2 * MaxAreasPerLeaf + 1>> LeafAreas = MoveTemp(TreeNodes[Node].Areas);
+	TreeNodes[Node].Areas.Reset();
+
+	const FVector2D Size = TreeNodes[Node].Bounds.GetSize();
+	const int32 Axis = Size.X >= Size.Y ? 0 : 1;
+
+	Algo::SortBy(LeafAreas, [this, Axis](const int32 AreaIndex)
+	{
+		return Areas[AreaIndex]->GetBounds().GetCenter()[Axis];
+	});
+
+	const int32 FirstChild = TreeNodes.AddDefaulted(2);
+	const int32 HalfCount = LeafAreas.Num() / 2;
+
+	for (int32 Index = 0; Index < LeafAreas.Num(); Index++)
+	{
+		const int32 Child = FirstChild + (Index < HalfCount ? 0 : 1);
+		TreeNodes[Child].Areas.Add(LeafAreas[Index]);
+		TreeNodes[Child].Bounds += Areas[LeafAreas[Index]]->GetBounds();
+		AreaEntries[LeafAreas[Index]].TreeLeaf = Child;
+	}
+
+	TreeNodes[FirstChild].Parent = Node;
+	TreeNodes[FirstChild + 1].Parent = Node;
+	TreeNodes[Node].Children[0] = FirstChild;
+	TreeNodes[Node].Children[1] = FirstChild + 1;
+}
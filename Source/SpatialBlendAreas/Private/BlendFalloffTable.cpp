@@ -0,0 +1,84 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendFalloffTable.h"
+#include "Curves/CurveFloat.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectKey.h"
+
+namespace BlendFalloffTable
+{
+	uint32 HashCurveKeys(const UCurveFloat* Curve)
+	{
+		if (Curve == nullptr)
+		{
+			return 0;
+		}
+
+		const FRichCurve& FloatCurve = Curve->FloatCurve;
+		uint32 Hash = HashCombine(GetTypeHash(FloatCurve.PreInfinityExtrap.GetValue()), GetTypeHash(FloatCurve.PostInfinityExtrap.GetValue()));
+
+		for (const FRichCurveKey& CurveKey : FloatCurve.GetConstRefOfKeys())
+		{
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.Time));
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.Value));
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.ArriveTangent));
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.LeaveTangent));
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.InterpMode.GetValue()));
+			Hash = HashCombine(Hash, GetTypeHash(CurveKey.TangentMode.GetValue()));
+		}
+
+		return Hash;
+	}
+}
+
+TSharedRef<const FBlendFalloffTable, ESPMode::ThreadSafe> FBlendFalloffTable::FindOrBake(const UCurveFloat* Curve, const EBlendFalloffDomain Domain)
+{
+	// The hash of the keys tells an edited curve from the one a cached table was baked from.
+	using FTableKey = TTuple<TObjectKey<UCurveFloat>, EBlendFalloffDomain, uint32>;
+
+	static FCriticalSection CacheLock;
+	static TMap<FTableKey, TWeakPtr<const FBlendFalloffTable, ESPMode::ThreadSafe>> Cache;
+
+	FScopeLock Lock(&CacheLock);
+	const FTableKey Key(Curve, Domain, BlendFalloffTable::HashCurveKeys(Curve));
+
+	if (TSharedPtr<const FBlendFalloffTable, ESPMode::ThreadSafe> CachedTable = Cache.FindRef(Key).Pin())
+	{
+		return CachedTable.ToSharedRef();
+	}
+
+	TSharedRef<FBlendFalloffTable, ESPMode::ThreadSafe> Table = MakeShared<FBlendFalloffTable, ESPMode::ThreadSafe>();
+
+	auto BakeSample = [Curve, Domain](const float Alpha)
+	{
+		const float Distance = Domain == EBlendFalloffDomain::Squared ? FMath::Sqrt(Alpha) : Alpha;
+		return Curve != nullptr ? FMath::Clamp(Curve->GetFloatValue(Distance), 0.f, 1.f) : Distance;
+	};
+
+	for (int32 Index = 0; Index < Resolution; Index++)
+	{
+		const float Alpha = static_cast<float>(Index) / (Resolution - 1);
+		Table->Samples[Index] = BakeSample(Alpha);
+		Table->NearSamples[Index] = BakeSample(Alpha * NearRange);
+	}
+
+	// Drop the entries of tables that are no longer referenced by any area.
+	for (auto It = Cache.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	Cache.Add(Key, Table);
+	return Table;
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendTraceReplayCommandlet.h"
+#include "BlendAreaCommandletUtils.h"
+#include "BlendArea.h"
+#include "BlendWeightDistributor.h"
+#include "BlendWeightTrace.h"
+
+UBlendTraceReplayCommandlet::UBlendTraceReplayCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UBlendTraceReplayCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	FString TracePath;
+	int32 Iterations = 1;
+
+	if (!FParse::Value(*Params, TEXT("Map="), MapName) || !FParse::Value(*Params, TEXT("Trace="), TracePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Usage: -run=BlendTraceReplay -Map=<map> -Trace=<file> [-Iterations=<count>]"))
+		return 1;
+	}
+
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+
+	FBlendWeightTrace Trace;
+
+	if (!Trace.LoadFromFile(TracePath))
+	{
+		return 1;
+	}
+
+	UWorld* World = BlendAreaCommandletUtils::LoadWorld(MapName);
+
+	if (World == nullptr)
+	{
+		return 1;
+	}
+
+	TArray<ABlendArea*> BlendAreas;
+	BlendAreaCommandletUtils::GatherBlendAreas(World, BlendAreas);
+
+	// Match the recorded areas by name.
+	TSet<const ABlendArea*> Registrees;
+	TArray<const ABlendArea*> RecordedAreas;
+	RecordedAreas.SetNumZeroed(Trace.AreaNames.Num());
+
+	for (int32 Index = 0; Index < Trace.AreaNames.Num(); Index++)
+	{
+		for (const ABlendArea* BlendArea : BlendAreas)
+		{
+			if (BlendArea->GetFName().ToString() == Trace.AreaNames[Index])
+			{
+				RecordedAreas[Index] = BlendArea;
+				Registrees.Add(BlendArea);
+				break;
+			}
+		}
+
+		if (RecordedAreas[Index] == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Recorded blend area '%s' was not found in '%s'."), *Trace.AreaNames[Index], *MapName)
+		}
+	}
+
+	UBlendWeightDistributor* Distributor = NewObject<UBlendWeightDistributor>();
+	Distributor->Initialize(Registrees);
+
+	TArray<int32> ReplayHandles;
+	ReplayHandles.SetNum(RecordedAreas.Num());
+
+	for (int32 Index = 0; Index < RecordedAreas.Num(); Index++)
+	{
+		ReplayHandles[Index] = Distributor->GetAreaHandle(RecordedAreas[Index]);
+	}
+
+	const int32 FrameCount = Trace.GetFrameCount();
+	TArray<double> FrameTimes;
+	FrameTimes.Reserve(FrameCount * Iterations);
+
+	double MaxDifference = 0.0;
+	double DifferenceSum = 0.0;
+	int32 MismatchingFrames = 0;
+
+	for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+	{
+		for (int32 Frame = 0; Frame < FrameCount; Frame++)
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Distributor->UpdateWeightData(Trace.Positions[Frame]);
+			FrameTimes.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0);
+
+			// Weight differences are the same on every iteration, so only compare on the first one.
+			if (Iteration > 0)
+			{
+				continue;
+			}
+
+			const TArrayView<const float> RecordedWeights = Trace.GetFrameWeights(Frame);
+			const TArrayView<const float> ReplayedWeights = Distributor->GetWeights();
+			double FrameMaxDifference = 0.0;
+
+			for (int32 Index = 0; Index < RecordedWeights.Num(); Index++)
+			{
+				const float ReplayedWeight = ReplayHandles[Index] != INDEX_NONE ? ReplayedWeights[ReplayHandles[Index]] : 0.f;
+				const double Difference = FMath::Abs(ReplayedWeight - RecordedWeights[Index]);
+				FrameMaxDifference = FMath::Max(FrameMaxDifference, Difference);
+				DifferenceSum += Difference;
+			}
+
+			MaxDifference = FMath::Max(MaxDifference, FrameMaxDifference);
+			MismatchingFrames += FrameMaxDifference > FBlendWeightTrace::QuantizationError * 2 ? 1 : 0;
+		}
+	}
+
+	FrameTimes.Sort();
+
+	UE_LOG(LogTemp, Display, TEXT("Replayed %d frames x %d iterations over %d blend areas."), FrameCount, Iterations, Registrees.Num())
+	UE_LOG(LogTemp, Display, TEXT("Frame time (us): p50 %.2f, p90 %.2f, p99 %.2f, max %.2f"),
+		   BlendAreaCommandletUtils::GetPercentile(FrameTimes, 50.0), BlendAreaCommandletUtils::GetPercentile(FrameTimes, 90.0),
+		   BlendAreaCommandletUtils::GetPercentile(FrameTimes, 99.0), BlendAreaCommandletUtils::GetPercentile(FrameTimes, 100.0))
+
+	const int32 ComparedWeights = FrameCount * Trace.AreaNames.Num();
+	UE_LOG(LogTemp, Display, TEXT("Weight difference: max %.6f, mean %.6f, %d of %d frames differ beyond quantization."),
+		   MaxDifference, ComparedWeights > 0 ? DifferenceSum / ComparedWeights : 0.0, MismatchingFrames, FrameCount)
+
+	BlendAreaCommandletUtils::UnloadWorld(World);
+	return 0;
+}
@@ -10,12 +10,56 @@ subjected to the respective product licensing terms.
 
 #include "BlendWeightDistributor.h"
 #include "BlendArea.h"
+#include "BlendAreaSubsystem.h"
+#include "Algo/Sort.h"
+
+DECLARE_STATS_GROUP(TEXT("SpatialBlendAreas"), STATGROUP_SpatialBlendAreas, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Budgeted Area Evaluations"), STAT_BudgetedAreaEvaluations, STATGROUP_SpatialBlendAreas);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Oldest Budgeted Area Result Age (Updates)"), STAT_OldestAreaResultAge, STATGROUP_SpatialBlendAreas);
 
 UBlendWeightDistributor::UBlendWeightDistributor()
 {
 }
 
-UBlendWeightDistributor::EResult UBlendWeightDistributor::Initialize(const TSet<const ABlendArea*>& Registrees) 
+template<typename AreaType>
+void UBlendWeightDistributor::InitializeBatch(TAreaBatch<AreaType>& Batch)
+{
+	Batch.Areas.Reserve(Batch.Handles.Num());
+	Batch.Weights.SetNumZeroed(Batch.Handles.Num());
+}
+
+template<typename AreaType>
+void UBlendWeightDistributor::EvaluateBatch(TAreaBatch<AreaType>& Batch, const FVector& Position)
+{
+	if (Batch.Handles.Num() == 0)
+	{
+		return;
+	}
+
+	Batch.Areas.Reset();
+
+	for (const int32 Handle : Batch.Handles)
+	{
+		Batch.Areas.Add(static_cast<const AreaType*>(Areas[Handle].Get()));
+	}
+
+	TBlendAreaKernel<AreaType>::EvaluateBatch(Batch.Areas, Position, Batch.Weights);
+
+	for (int32 Index = 0; Index < Batch.Handles.Num(); Index++)
+	{
+		const int32 Handle = Batch.Handles[Index];
+		const float BlendWeight = Batch.Weights[Index];
+		Weights[Handle] = BlendWeight;
+
+		// Ignore areas with zero blend weight.
+		if (BlendWeight > 0)
+		{
+			RelevantAreas.Add(Handle);
+		}
+	}
+}
+
+UBlendWeightDistributor::EResult UBlendWeightDistributor::Initialize(const TSet<const ABlendArea*>& Registrees, UBlendAreaSubsystem* InSharedEvaluator)
 {
 	if (bIsInitialized)
 	{
@@ -23,22 +67,115 @@ UBlendWeightDistributor::EResult UBlendWeightDistributor::Initialize(const TSet<
 	}
 
 	const uint32 AreaCount = Registrees.Num();
-	AreaWeights.Reserve(AreaCount);
+	Areas.Reserve(AreaCount);
+	AreaHandles.Reserve(AreaCount);
+	// All per-update scratch is sized for every area up front, so updates never grow it.
 	RelevantAreas.Reserve(AreaCount);
-	SharedPriorityAreas.Reserve(AreaCount);
 
 	for (const auto& Area : Registrees)
 	{
-		if (!AreaWeights.Contains(Area))
+		if (!AreaHandles.Contains(Area))
 		{
-			AreaWeights.Add(Area, 0.f);
+			AreaHandles.Add(Area, Areas.Num());
+			Areas.Add(Area);
 		}
 	}
 
+	// Group the areas by type, so that each group is evaluated in one statically bound loop.
+	AreaKinds.Reserve(Areas.Num());
+
+	for (int32 Handle = 0; Handle < Areas.Num(); Handle++)
+	{
+		const EBlendAreaKind Kind = BlendAreaKernels::GetKind(Areas[Handle].Get());
+		AreaKinds.Add(Kind);
+
+		switch (Kind)
+		{
+		case EBlendAreaKind::Horizontal:
+			HorizontalBatch.Handles.Add(Handle);
+			break;
+		case EBlendAreaKind::Vertical:
+			VerticalBatch.Handles.Add(Handle);
+			break;
+		default:
+			CustomBatch.Handles.Add(Handle);
+			break;
+		}
+	}
+
+	InitializeBatch(HorizontalBatch);
+	InitializeBatch(VerticalBatch);
+	InitializeBatch(CustomBatch);
+
+	if (InSharedEvaluator != nullptr)
+	{
+		SharedEvaluator = InSharedEvaluator;
+		SharedAreaIndices.Init(INDEX_NONE, Areas.Num());
+
+		for (int32 Handle = 0; Handle < Areas.Num(); Handle++)
+		{
+			const int32 SharedIndex = InSharedEvaluator->RegisterArea(Areas[Handle].Get());
+			SharedAreaIndices[Handle] = SharedIndex;
+
+			if (SharedIndex != INDEX_NONE)
+			{
+				while (SharedAreaHandles.Num() <= SharedIndex)
+				{
+					SharedAreaHandles.Add(INDEX_NONE);
+				}
+
+				SharedAreaHandles[SharedIndex] = Handle;
+			}
+		}
+	}
+
+	Weights.SetNumZeroed(Areas.Num());
+	PreviousWeights.SetNumZeroed(Areas.Num());
+	IsolatedWeights.SetNumZeroed(Areas.Num());
+	EvaluatedFrames.SetNumZeroed(Areas.Num());
+	EvaluatedPositions.SetNumZeroed(Areas.Num());
+	CandidateFrames.SetNumZeroed(Areas.Num());
+	PendingAreas.Reserve(AreaCount);
+	ActiveAreas.Reserve(AreaCount);
+	PreviousActiveAreas.Reserve(AreaCount);
+	SnapshotBuffer = MakeShared<FBlendWeightSnapshotBuffer, ESPMode::ThreadSafe>(Areas.Num());
+
 	bIsInitialized = true;
 	return EResult::OK;
 }
 
+int32 UBlendWeightDistributor::GetAreaHandle(const ABlendArea* BlendArea) const
+{
+	const int32* Handle = AreaHandles.Find(BlendArea);
+	return Handle != nullptr ? *Handle : INDEX_NONE;
+}
+
+int32 UBlendWeightDistributor::GetSharedHandle(const FBlendAreaCandidate& Candidate, const UBlendAreaSubsystem& Evaluator) const
+{
+	const int32 Handle = SharedAreaHandles.IsValidIndex(Candidate.AreaIndex) ? SharedAreaHandles[Candidate.AreaIndex] : INDEX_NONE;
+
+	// The shared index of an unregistered area may since have been handed out to another area.
+	if (Handle == INDEX_NONE || Areas[Handle] != Evaluator.GetAreas()[Candidate.AreaIndex])
+	{
+		return INDEX_NONE;
+	}
+
+	return Handle;
+}
+
+int32 UBlendWeightDistributor::GetSharedIndex(const int32 Handle, const UBlendAreaSubsystem& Evaluator) const
+{
+	const int32 SharedIndex = SharedAreaIndices.IsValidIndex(Handle) ? SharedAreaIndices[Handle] : INDEX_NONE;
+
+	// The reverse of GetSharedHandle(): once the area has left the evaluator, the index may belong to another area.
+	if (SharedIndex == INDEX_NONE || !Evaluator.GetAreas().IsValidIndex(SharedIndex) || Evaluator.GetAreas()[SharedIndex] != Areas[Handle])
+	{
+		return INDEX_NONE;
+	}
+
+	return SharedIndex;
+}
+
 UBlendWeightDistributor::EResult UBlendWeightDistributor::GetWeight(const ABlendArea*& BlendArea, float& OutWeight)
 {
 	if (!bIsInitialized)
@@ -51,14 +188,14 @@ UBlendWeightDistributor::EResult UBlendWeightDistributor::GetWeight(const ABlend
 		return EResult::ERR_INVALID_AREA;
 	}
 
-	float* Weight = AreaWeights.Find(BlendArea);
+	const int32 Handle = GetAreaHandle(BlendArea);
 
-	if (Weight == nullptr)
+	if (Handle == INDEX_NONE)
 	{
 		return EResult::ERR_UNREGISTERED_AREA;
 	}
 
-	OutWeight = *Weight;
+	OutWeight = Weights[Handle];
 	return EResult::OK;
 }
 
@@ -71,100 +208,314 @@ UBlendWeightDistributor::EResult UBlendWeightDistributor::UpdateWeightData(const
 
 	RelevantAreas.Reset();
 
-	for (auto& Item : AreaWeights)
+	bool bIsSorted = false;
+
+	if (TimeBudgetMicroseconds > 0.f)
 	{
-		if (!Item.Key.IsValid())
+		UpdateIsolatedWeightsBudgeted(Position);
+
+		for (int32 Handle = 0; Handle < Areas.Num(); Handle++)
 		{
-			Item.Value = 0.f;
-			continue;
+			Weights[Handle] = IsolatedWeights[Handle];
+
+			if (Weights[Handle] > 0)
+			{
+				RelevantAreas.Add(Handle);
+			}
 		}
+	}
+	else if (UBlendAreaSubsystem* Evaluator = SharedEvaluator.Get())
+	{
+		// Other distributors querying the same position this frame reuse the weights evaluated here, and vice versa.
+		const int32 PositionSlot = Evaluator->FindOrAddPosition(Position);
 
-		// Get the blend weight for each area as an isolated case.
-		const float BlendWeight = Item.Key->GetBlendWeight(Position);
-		Item.Value = BlendWeight;
+		// Only the candidates of the arrangement cell can have a weight. They come in priority order,
+		// so the relevant areas need no sorting either.
+		FMemory::Memzero(Weights.GetData(), Weights.Num() * sizeof(float));
+		bIsSorted = true;
 
-		// Ignore areas with zero blend weight.
-		if (BlendWeight > 0)
+		for (const FBlendAreaCandidate& Candidate : Evaluator->GetCandidates(PositionSlot))
 		{
-			RelevantAreas.Add(Item.Key);
+			const int32 Handle = GetSharedHandle(Candidate, *Evaluator);
+
+			if (Handle == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const float BlendWeight = Evaluator->GetBlendWeight(Candidate.AreaIndex, PositionSlot);
+			Weights[Handle] = BlendWeight;
+
+			if (BlendWeight > 0)
+			{
+				RelevantAreas.Add(Handle);
+			}
 		}
 	}
+	else
+	{
+		// Get the blend weight for each area as an isolated case, one type at a time.
+		EvaluateBatch(HorizontalBatch, Position);
+		EvaluateBatch(VerticalBatch, Position);
+		EvaluateBatch(CustomBatch, Position);
+	}
 
-	if (RelevantAreas.Num() <= 1)
+	if (RelevantAreas.Num() > 1)
 	{
-		return EResult::OK;
+		DistributeByPriority(bIsSorted);
 	}
 
-	// Sort by priority, so that the higher priority blend areas consume the weight budget first.
-	Algo::SortBy(RelevantAreas, [](const TWeakObjectPtr<const ABlendArea> Area) 
-								{ return Area.IsValid() ? Area->Priority : 0; }, TGreater<uint32>());
+	SnapshotBuffer->Publish(++FrameNumber, Weights);
+	BroadcastStateChanges();
+	return EResult::OK;
+}
 
-	SharedPriorityAreas.Reset();
-	float RemainingWeightBudget = 1.f;
+void UBlendWeightDistributor::SetTimeBudget(const float Microseconds)
+{
+	TimeBudgetMicroseconds = FMath::Max(Microseconds, 0.f);
+	OldestResultAge = 0;
+	bHasPendingPosition = false;
+}
 
-	auto DistributeWeights = [&]()
+void UBlendWeightDistributor::UpdateIsolatedWeightsBudgeted(const FVector& Position)
+{
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	const uint64 BudgetCycles = static_cast<uint64>(TimeBudgetMicroseconds / (FPlatformTime::GetSecondsPerCycle64() * 1000000.0));
+	const uint64 UpdateNumber = FrameNumber + 1;
+	UBlendAreaSubsystem* Evaluator = SharedEvaluator.Get();
+
+	if (bHasPendingPosition && Position == PendingPosition)
 	{
-		float WeightsSum = 0.f;
+		// The candidates and the sort keys of the areas still pending are unchanged, so the order still holds.
+		PendingAreas.RemoveAll([this, &Position](const int32 Handle)
+		{
+			return EvaluatedFrames[Handle] != 0 && EvaluatedPositions[Handle] == Position;
+		});
+	}
+	else
+	{
+		GatherPendingAreas(Evaluator, Position, UpdateNumber);
+		PendingPosition = Position;
+		bHasPendingPosition = true;
+	}
 
-		for (const auto& Area : SharedPriorityAreas)
+	// Areas evaluated through the shared evaluator may already have been evaluated by another distributor this frame.
+	const int32 PositionSlot = Evaluator != nullptr && PendingAreas.Num() > 0 ? Evaluator->FindOrAddPosition(Position) : INDEX_NONE;
+	int32 EvaluatedCount = 0;
+
+	for (const int32 Handle : PendingAreas)
+	{
+		if (EvaluatedCount > 0 && FPlatformTime::Cycles64() - StartCycles >= BudgetCycles)
 		{
-			WeightsSum += AreaWeights[Area];
+			break;
 		}
 
-		// If the remaining weight budget does not cover the sum of weights in this priority group,
-		// distribute the rest of the budget based on the relative importance of each area.
-		if (WeightsSum > RemainingWeightBudget)
+		// The pending areas may have been gathered on an earlier update, so the area may have been destroyed since.
+		const ABlendArea* Area = Areas[Handle].Get();
+		const int32 SharedIndex = PositionSlot != INDEX_NONE ? GetSharedIndex(Handle, *Evaluator) : INDEX_NONE;
+
+		if (Area == nullptr)
 		{
-			for (const auto& Area : SharedPriorityAreas)
-			{
-				float OriginalWeight = AreaWeights[Area];
-				float AdjustedWeight = RemainingWeightBudget * OriginalWeight / WeightsSum;
-				AreaWeights[Area] = AdjustedWeight;
-			}
+			IsolatedWeights[Handle] = 0.f;
+		}
+		else if (SharedIndex != INDEX_NONE)
+		{
+			IsolatedWeights[Handle] = Evaluator->GetBlendWeight(SharedIndex, PositionSlot);
+		}
+		else
+		{
+			IsolatedWeights[Handle] = BlendAreaKernels::GetBlendWeight(AreaKinds[Handle], *Area, Position);
 		}
 
-		RemainingWeightBudget = FMath::Clamp((RemainingWeightBudget - WeightsSum), 0, 1);
-	};
-	
-	// Distribute the overall weight budget (i.e. 1) by going through one priority group at a time.
-	for (int32 Index = 0; Index < RelevantAreas.Num() - 1; Index++)
+		EvaluatedFrames[Handle] = UpdateNumber;
+		EvaluatedPositions[Handle] = Position;
+		EvaluatedCount++;
+	}
+
+	OldestResultAge = 0;
+
+	for (const int32 Handle : PendingAreas)
 	{
-		const ABlendArea* const& AreaA = RelevantAreas[Index].Get();
-		const ABlendArea* const& AreaB = RelevantAreas[Index + 1].Get();
+		OldestResultAge = FMath::Max(OldestResultAge, UpdateNumber - EvaluatedFrames[Handle]);
+	}
+
+	INC_DWORD_STAT_BY(STAT_BudgetedAreaEvaluations, EvaluatedCount);
+	SET_DWORD_STAT(STAT_OldestAreaResultAge, OldestResultAge);
+}
 
-		if (AreaA->Priority == AreaB->Priority)
+void UBlendWeightDistributor::GatherPendingAreas(UBlendAreaSubsystem* Evaluator, const FVector& Position, const uint64 UpdateNumber)
+{
+	PendingAreas.Reset();
+
+	if (Evaluator != nullptr)
+	{
+		// The broad-phase of the shared evaluator: only the candidates of the cells at the position can have a weight.
+		for (const FBlendAreaCandidate& Candidate : Evaluator->GetCandidates(Evaluator->FindOrAddPosition(Position)))
 		{
-			if (!SharedPriorityAreas.Contains(AreaA))
+			const int32 Handle = GetSharedHandle(Candidate, *Evaluator);
+
+			if (Handle != INDEX_NONE)
 			{
-				SharedPriorityAreas.Add(AreaA);
+				CandidateFrames[Handle] = UpdateNumber;
 			}
+		}
+	}
 
-			SharedPriorityAreas.Add(AreaB);
+	const FVector2D Position2D = FVector2D(Position.X, Position.Y);
 
-			if (Index == RelevantAreas.Num() - 2)
-			{
-				DistributeWeights();
-			}
+	for (int32 Handle = 0; Handle < Areas.Num(); Handle++)
+	{
+		const ABlendArea* Area = Areas[Handle].Get();
+		bool bCanHaveWeight = false;
+
+		if (Evaluator != nullptr && GetSharedIndex(Handle, *Evaluator) != INDEX_NONE)
+		{
+			bCanHaveWeight = CandidateFrames[Handle] == UpdateNumber;
 		}
 		else
 		{
-			if (!SharedPriorityAreas.Contains(AreaA))
-			{
-				SharedPriorityAreas.Add(AreaA);
-			}
+			bCanHaveWeight = Area != nullptr && Area->GetBounds().bIsValid && Area->GetBounds().ComputeSquaredDistanceToPoint(Position2D) == 0.0;
+		}
 
-			DistributeWeights();
-			SharedPriorityAreas.Reset();
+		// Outside the candidates or the bounds the weight is exactly zero, which costs next to nothing to establish.
+		// A result evaluated at the very same position is exact as well.
+		if (!bCanHaveWeight)
+		{
+			IsolatedWeights[Handle] = 0.f;
+			EvaluatedFrames[Handle] = UpdateNumber;
+			EvaluatedPositions[Handle] = Position;
+		}
+		else if (EvaluatedFrames[Handle] == 0 || EvaluatedPositions[Handle] != Position)
+		{
+			PendingAreas.Add(Handle);
+		}
+		else
+		{
+			EvaluatedFrames[Handle] = UpdateNumber;
+		}
+	}
 
-			if (Index == RelevantAreas.Num() - 2)
+	// The results evaluated farthest from the current position are the most likely to be off, so they go first.
+	Algo::SortBy(PendingAreas, [this, &Position](const int32 Handle)
+	{
+		return EvaluatedFrames[Handle] == 0 ? TNumericLimits<double>::Max() : FVector::DistSquared(EvaluatedPositions[Handle], Position);
+	}, TGreater<double>());
+}
+
+void UBlendWeightDistributor::SetWeightThresholds(TArrayView<const float> Thresholds)
+{
+	WeightThresholds.Reset();
+	WeightThresholds.Append(Thresholds.GetData(), Thresholds.Num());
+	WeightThresholds.Sort();
+}
+
+void UBlendWeightDistributor::BroadcastStateChanges()
+{
+	// Only areas that are active now or were active on the previous update can have changed state,
+	// so the cost scales with the number of overlapping areas instead of the number of registered ones.
+	Swap(ActiveAreas, PreviousActiveAreas);
+	ActiveAreas.Reset();
+
+	for (const int32 Handle : RelevantAreas)
+	{
+		if (Weights[Handle] > 0)
+		{
+			ActiveAreas.Add(Handle);
+		}
+	}
+
+	for (const int32 Handle : PreviousActiveAreas)
+	{
+		if (Weights[Handle] <= 0)
+		{
+			BroadcastThresholdCrossings(Handle, PreviousWeights[Handle], 0.f);
+			PreviousWeights[Handle] = 0.f;
+			OnAreaExited.Broadcast(Areas[Handle].Get());
+		}
+	}
+
+	for (const int32 Handle : ActiveAreas)
+	{
+		const float PreviousWeight = PreviousWeights[Handle];
+		const float Weight = Weights[Handle];
+		PreviousWeights[Handle] = Weight;
+
+		if (PreviousWeight <= 0)
+		{
+			OnAreaEntered.Broadcast(Areas[Handle].Get(), Weight);
+		}
+
+		BroadcastThresholdCrossings(Handle, PreviousWeight, Weight);
+	}
+}
+
+void UBlendWeightDistributor::BroadcastThresholdCrossings(const int32 Handle, const float PreviousWeight, const float Weight)
+{
+	if (PreviousWeight == Weight || !OnWeightThresholdCrossed.IsBound())
+	{
+		return;
+	}
+
+	for (const float Threshold : WeightThresholds)
+	{
+		const bool bWasAbove = PreviousWeight >= Threshold;
+		const bool bIsAbove = Weight >= Threshold;
+
+		if (bWasAbove != bIsAbove)
+		{
+			OnWeightThresholdCrossed.Broadcast(Areas[Handle].Get(), Threshold, Weight, bIsAbove);
+		}
+	}
+}
+
+void UBlendWeightDistributor::DistributeByPriority(const bool bIsSorted)
+{
+	auto GetPriority = [this](const int32 Handle)
+	{
+		return Areas[Handle].IsValid() ? Areas[Handle]->Priority : 0;
+	};
+
+	// Sort by priority, so that the higher priority blend areas consume the weight budget first.
+	if (!bIsSorted)
+	{
+		Algo::SortBy(RelevantAreas, GetPriority, TGreater<uint32>());
+	}
+
+	float RemainingWeightBudget = 1.f;
+
+	// Distribute the overall weight budget (i.e. 1) by going through one priority group at a time.
+	// The groups are consecutive ranges of the sorted areas, so no list needs to be gathered for them.
+	for (int32 GroupStart = 0; GroupStart < RelevantAreas.Num();)
+	{
+		const uint32 GroupPriority = GetPriority(RelevantAreas[GroupStart]);
+		int32 GroupEnd = GroupStart + 1;
+
+		while (GroupEnd < RelevantAreas.Num() && GetPriority(RelevantAreas[GroupEnd]) == GroupPriority)
+		{
+			GroupEnd++;
+		}
+
+		float WeightsSum = 0.f;
+
+		for (int32 Index = GroupStart; Index < GroupEnd; Index++)
+		{
+			WeightsSum += Weights[RelevantAreas[Index]];
+		}
+
+		// If the remaining weight budget does not cover the sum of weights in this priority group,
+		// distribute the rest of the budget based on the relative importance of each area.
+		if (WeightsSum > RemainingWeightBudget)
+		{
+			for (int32 Index = GroupStart; Index < GroupEnd; Index++)
 			{
-				SharedPriorityAreas.Add(AreaB);
-				DistributeWeights();
+				const int32 Handle = RelevantAreas[Index];
+				Weights[Handle] = RemainingWeightBudget * Weights[Handle] / WeightsSum;
 			}
 		}
+
+		RemainingWeightBudget = FMath::Clamp((RemainingWeightBudget - WeightsSum), 0, 1);
+		GroupStart = GroupEnd;
 	}
-	
-	return EResult::OK;
 }
 
  UBlendWeightDistributor::EResult UBlendWeightDistributor::GetAllWeights(TMap<TWeakObjectPtr<const ABlendArea>, float>& OutWeights)
@@ -174,7 +525,14 @@ UBlendWeightDistributor::EResult UBlendWeightDistributor::UpdateWeightData(const
 		 return EResult::ERR_UNINITIALIZED;
 	 }
 
-	 OutWeights = AreaWeights;
+	 OutWeights.Reset();
+	 OutWeights.Reserve(Areas.Num());
+
+	 for (int32 Handle = 0; Handle < Areas.Num(); Handle++)
+	 {
+		 OutWeights.Add(Areas[Handle], Weights[Handle]);
+	 }
+
 	 return EResult::OK;
 }
 
@@ -12,9 +12,11 @@ subjected to the respective product licensing terms.
 #include "Components/SceneComponent.h"
 #include "BlendArea.h"
 #include "BlendWeightInterface.h"
+#include "BlendWeightSink.h"
 #include "BlendWeightDistributor.h"
+#include "BlendAreaSubsystem.h"
 #include "AudioDevice.h"
-#include "Kismet/KismetTextLibrary.h"
+#include "Misc/Paths.h"
 
 ABlendWeightManager::ABlendWeightManager()
 {
@@ -33,42 +35,168 @@ void ABlendWeightManager::PostInitializeComponents()
 	GetComponents(ActorComponents);
 	TSet<const ABlendArea*> AllBlendAreas;
 
+	auto GatherBlendAreas = [&AllBlendAreas](const TSet<const ABlendArea*>& BlendAreas)
+	{
+		for (const auto& BlendArea : BlendAreas)
+		{
+			if (IsValid(BlendArea) && !AllBlendAreas.Contains(BlendArea))
+			{
+				AllBlendAreas.Add(BlendArea);
+			}
+		}
+	};
+
 	for (const auto& Component : ActorComponents)
 	{
-		IBlendWeightInterface* BlendWeightInterface = Cast<IBlendWeightInterface>(Component);
+		FWeightSinkBinding Binding;
+		Binding.Object = Component;
+		Binding.Sink = Cast<IBlendWeightSink>(Component);
+		Binding.Interface = Binding.Sink == nullptr ? Cast<IBlendWeightInterface>(Component) : nullptr;
+
+		if (Binding.Sink != nullptr)
+		{
+			Binding.ChannelCount = FMath::Max(Binding.Sink->GetChannelCount(), 0);
 
-		if (BlendWeightInterface == nullptr)
+			for (int32 Channel = 0; Channel < Binding.ChannelCount; Channel++)
+			{
+				GatherBlendAreas(Binding.Sink->GetChannelBlendAreas(Channel));
+			}
+		}
+		else if (Binding.Interface != nullptr)
+		{
+			Binding.ChannelCount = 1;
+			GatherBlendAreas(Binding.Interface->GetBlendAreas());
+		}
+		else
 		{
 			continue;
 		}
 
-		ScriptInterfaces.Add(TScriptInterface<IBlendWeightInterface>(Component));
+		SinkBindingIndices.Add(Component, SinkBindings.Add(Binding));
+	}
+
+	BlendWeightDistributor = NewObject<UBlendWeightDistributor>();
+	BlendWeightDistributor->Initialize(AllBlendAreas, UWorld::GetSubsystem<UBlendAreaSubsystem>(GetWorld()));
+	BlendWeightDistributor->SetTimeBudget(EvaluationBudgetMicroseconds);
+
+	// Resolve the areas of every channel to distributor handles once, so the per-tick summing needs no lookups.
+	ChannelAreaOffsets.Reset();
+	ChannelAreaOffsets.Add(0);
 
-		for (const auto& BlendArea : BlendWeightInterface->GetBlendAreas())
+	for (auto& Binding : SinkBindings)
+	{
+		Binding.FirstChannel = ChannelAreaOffsets.Num() - 1;
+
+		if (Binding.Sink != nullptr)
 		{
-			if (IsValid(BlendArea) && !AllBlendAreas.Contains(BlendArea))
+			for (int32 Channel = 0; Channel < Binding.ChannelCount; Channel++)
 			{
-				AllBlendAreas.Add(BlendArea);
+				AddChannel(Binding.Sink->GetChannelBlendAreas(Channel));
 			}
 		}
+		else
+		{
+			AddChannel(Binding.Interface->GetBlendAreas());
+		}
 	}
 
-	BlendWeightDistributor = NewObject<UBlendWeightDistributor>();
-	BlendWeightDistributor->Initialize(AllBlendAreas);
+	TargetWeights.SetNumZeroed(ChannelAreaOffsets.Num() - 1);
+	OutputWeights.SetNumZeroed(ChannelAreaOffsets.Num() - 1);
+}
+
+void ABlendWeightManager::AddChannel(const TSet<const ABlendArea*>& ChannelAreas)
+{
+	for (const auto& BlendArea : ChannelAreas)
+	{
+		const int32 Handle = BlendWeightDistributor->GetAreaHandle(BlendArea);
+
+		if (Handle != INDEX_NONE)
+		{
+			ChannelAreaHandles.Add(Handle);
+		}
+	}
+
+	ChannelAreaOffsets.Add(ChannelAreaHandles.Num());
 }
 
 void ABlendWeightManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+#if !UE_BUILD_SHIPPING
+	if (bRecordListenerTrace)
+	{
+		StartTraceRecording();
+	}
+#endif
+}
+
+void ABlendWeightManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+	TraceWriter.Close();
+}
+
+void ABlendWeightManager::StartTraceRecording()
+{
+	if (!IsValid(BlendWeightDistributor))
+	{
+		return;
+	}
+
+	FString FilePath = TraceFilePath;
+
+	if (FilePath.IsEmpty())
+	{
+		FilePath = FString::Printf(TEXT("%s_%s.bwtrace"), *GetName(), *FDateTime::Now().ToString());
+	}
+
+	if (FPaths::IsRelative(FilePath))
+	{
+		FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("BlendTraces"), FilePath);
+	}
+
+	TArray<FString> AreaNames;
+
+	for (const auto& Area : BlendWeightDistributor->GetAreas())
+	{
+		AreaNames.Add(Area.IsValid() ? Area->GetFName().ToString() : FString());
+	}
+
+	if (TraceWriter.Open(FilePath, AreaNames))
+	{
+		UE_LOG(LogTemp, Log, TEXT("Recording blend weight trace to '%s'."), *FilePath)
+	}
 }
 
 void ABlendWeightManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	FVector BlendPosition;
-	GetBlendPosition(BlendPosition);
-	UpdateWeights(BlendPosition);
+	EvaluationTimer -= DeltaTime;
+	bool bWeightsChanged = false;
+
+	if (EvaluationTimer <= 0.f || !bHasEvaluated)
+	{
+		// Keep the remainder, so the average rate holds regardless of the frame rate, but never queue up evaluations.
+		EvaluationTimer = FMath::Max(EvaluationTimer + EvaluationInterval, 0.f);
+
+		FVector BlendPosition;
+		GetBlendPosition(BlendPosition);
+		UpdateWeights(BlendPosition);
+		bWeightsChanged = true;
+
+		if (TraceWriter.IsOpen())
+		{
+			TraceWriter.WriteFrame(BlendPosition, BlendWeightDistributor->GetWeights());
+		}
+	}
+
+	if (bWeightsChanged || bIsSmoothing)
+	{
+		SmoothWeights(DeltaTime);
+		DispatchWeights();
+	}
 
 #if WITH_EDITOR
 
@@ -99,10 +227,7 @@ void ABlendWeightManager::UpdateWeights(const FVector& BlendPosition)
 		return;
 	}
 
-	// This single result variable potentially gets re-used multiple times below.
-	UBlendWeightDistributor::EResult Result;
-
-	Result = BlendWeightDistributor->UpdateWeightData(BlendPosition);
+	const UBlendWeightDistributor::EResult Result = BlendWeightDistributor->UpdateWeightData(BlendPosition);
 
 	if (Result != UBlendWeightDistributor::EResult::OK)
 	{
@@ -110,41 +235,144 @@ void ABlendWeightManager::UpdateWeights(const FVector& BlendPosition)
 		return;
 	}
 
-	for (auto& ScriptInterface : ScriptInterfaces)
+	const TArrayView<const float> AreaWeights = BlendWeightDistributor->GetWeights();
+
+	for (int32 Channel = 0; Channel < OutputWeights.Num(); Channel++)
+	{
+		float TotalWeight = 0.f;
+
+		for (int32 Index = ChannelAreaOffsets[Channel]; Index < ChannelAreaOffsets[Channel + 1]; Index++)
+		{
+			TotalWeight += AreaWeights[ChannelAreaHandles[Index]];
+		}
+
+		TargetWeights[Channel] = FMath::Clamp(TotalWeight, 0, 1);
+	}
+
+	// Start from the first evaluated weights instead of fading in from zero.
+	if (!bHasEvaluated)
+	{
+		CopyTargetWeights();
+		bHasEvaluated = true;
+	}
+}
+
+void ABlendWeightManager::SmoothWeights(const float DeltaTime)
+{
+	if (!ShouldSmoothWeights())
+	{
+		CopyTargetWeights();
+		bIsSmoothing = false;
+		return;
+	}
+
+	if (DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+	// Exponential smoothing with a per-frame factor derived from the elapsed time, so the response does not depend on the frame rate.
+	const float Alpha = 1.f - FMath::Exp(-DeltaTime / SmoothingTimeConstant);
+
+	// Changes below this are inaudible; snapping to the target lets settled channels stop changing and being dispatched.
+	constexpr float SettleThreshold = 1e-4f;
+
+	const float* Targets = TargetWeights.GetData();
+	float* Outputs = OutputWeights.GetData();
+	const int32 ChannelCount = OutputWeights.Num();
+
+	const VectorRegister4Float VectorAlpha = VectorSetFloat1(Alpha);
+	const VectorRegister4Float VectorThreshold = VectorSetFloat1(SettleThreshold);
+	VectorRegister4Float UnsettledMask = VectorZeroFloat();
+	int32 Channel = 0;
+
+	for (; Channel + 4 <= ChannelCount; Channel += 4)
+	{
+		const VectorRegister4Float Target = VectorLoad(Targets + Channel);
+		const VectorRegister4Float Output = VectorLoad(Outputs + Channel);
+		const VectorRegister4Float Delta = VectorSubtract(Target, Output);
+		const VectorRegister4Float Mask = VectorCompareGT(VectorAbs(Delta), VectorThreshold);
+
+		VectorStore(VectorSelect(Mask, VectorMultiplyAdd(Delta, VectorAlpha, Output), Target), Outputs + Channel);
+		UnsettledMask = VectorBitwiseOr(UnsettledMask, Mask);
+	}
+
+	bool bUnsettled = VectorMaskBits(UnsettledMask) != 0;
+
+	for (; Channel < ChannelCount; Channel++)
+	{
+		const float Delta = Targets[Channel] - Outputs[Channel];
+		const bool bChannelUnsettled = FMath::Abs(Delta) > SettleThreshold;
+		Outputs[Channel] = bChannelUnsettled ? Outputs[Channel] + Delta * Alpha : Targets[Channel];
+		bUnsettled |= bChannelUnsettled;
+	}
+
+	bIsSmoothing = bUnsettled;
+}
+
+void ABlendWeightManager::CopyTargetWeights()
+{
+	// Both arrays are sized once on initialization; copy the values without going through array assignment.
+	FMemory::Memcpy(OutputWeights.GetData(), TargetWeights.GetData(), OutputWeights.Num() * sizeof(float));
+}
+
+void ABlendWeightManager::DispatchWeights()
+{
+	const TArrayView<const float> Weights = OutputWeights;
+
+	for (const auto& Binding : SinkBindings)
 	{
-		if (ScriptInterface.GetInterface() == nullptr)
+		if (!Binding.Object.IsValid())
 		{
 			continue;
 		}
 
-		TSet<const ABlendArea*> BlendAreas = ScriptInterface->GetBlendAreas();
-		float TotalWeight = 0.f;
-
-		for (auto& BlendArea : BlendAreas)
+		if (Binding.Sink != nullptr)
 		{
-			if (!IsValid(BlendArea))
-			{
-				continue;
-			}
+			Binding.Sink->SetWeights(Weights.Slice(Binding.FirstChannel, Binding.ChannelCount));
+		}
+		else
+		{
+			Binding.Interface->SetWeight(Weights[Binding.FirstChannel]);
+		}
+	}
+}
 
-			float Weight = 0.f;
-			Result = BlendWeightDistributor->GetWeight(BlendArea, Weight);
+bool ABlendWeightManager::GetOutputWeight(const UObject* Consumer, float& OutWeight, const int32 Channel) const
+{
+	const int32* BindingIndex = SinkBindingIndices.Find(Consumer);
 
-			if (Result != UBlendWeightDistributor::EResult::OK)
-			{
-				UBlendWeightDistributor::LogResult(Result);
-			}
+	if (BindingIndex == nullptr)
+	{
+		return false;
+	}
 
-			TotalWeight += Weight;
-		}
+	// A destroyed consumer may have left its address to an unrelated object.
+	const FWeightSinkBinding& Binding = SinkBindings[*BindingIndex];
 
-		TotalWeight = FMath::Clamp(TotalWeight, 0, 1);
-		ScriptInterface->SetWeight(TotalWeight);
+	if (Binding.Object.Get() != Consumer || Channel < 0 || Channel >= Binding.ChannelCount)
+	{
+		return false;
 	}
+
+	OutWeight = OutputWeights[Binding.FirstChannel + Channel];
+	return true;
 }
 
 #if WITH_EDITOR
 
+/** Appends ": <weight>" with two decimals without going through a temporary formatted string. */
+static void AppendDebugWeight(FString& Message, const float Weight)
+{
+	const int32 Hundredths = FMath::RoundToInt(FMath::Clamp(Weight, 0.f, 1.f) * 100.f);
+
+	Message += TEXT(": ");
+	Message.AppendInt(Hundredths / 100);
+	Message.AppendChar(TEXT('.'));
+	Message.AppendChar(TEXT('0') + Hundredths % 100 / 10);
+	Message.AppendChar(TEXT('0') + Hundredths % 10);
+}
+
 void ABlendWeightManager::DebugWeights()
 {
 	if (GEngine == nullptr)
@@ -152,54 +380,60 @@ void ABlendWeightManager::DebugWeights()
 		return;
 	}
 
-	GEngine->ClearOnScreenDebugMessages();
+	// Messages are keyed per line instead of clearing the whole on-screen message list every frame,
+	// so each line is replaced in place and other systems' messages are left untouched.
+	const uint64 KeyBase = static_cast<uint64>(GetUniqueID()) << 32;
 
 	if (bDebugBlendAreaWeights && BlendWeightDistributor != nullptr)
 	{
-		TMap<TWeakObjectPtr<const ABlendArea>, float> Weights;
-		
-		auto Result = BlendWeightDistributor->GetAllWeights(Weights);
+		const TArrayView<const TWeakObjectPtr<const ABlendArea>> Areas = BlendWeightDistributor->GetAreas();
+		const TArrayView<const float> Weights = BlendWeightDistributor->GetWeights();
 
-		if (Result == UBlendWeightDistributor::EResult::OK)
+		for (int32 Index = 0; Index < Areas.Num() && Index < Weights.Num(); Index++)
 		{
-			for (const auto& Item : Weights)
-			{
-				if (!Item.Key.IsValid())
-				{
-					continue;
-				}
+			const ABlendArea* Area = Areas[Index].Get();
 
-				FString Name = Item.Key->GetActorLabel();
-				FString TruncatedValue = UKismetTextLibrary::Conv_FloatToText(Item.Value, ERoundingMode::HalfToEven, false, true, 1, 324, 0, 2).ToString();
-				FString Message = Name + ": " + TruncatedValue;
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Magenta, Message);		
+			if (Area == nullptr)
+			{
+				continue;
 			}
-		}
-		else
-		{
-			UBlendWeightDistributor::LogResult(Result);
+
+			DebugMessage.Reset();
+			DebugMessage += Area->GetActorLabel();
+			AppendDebugWeight(DebugMessage, Weights[Index]);
+			GEngine->AddOnScreenDebugMessage(KeyBase | Index, 1.0f, FColor::Magenta, DebugMessage);
 		}
 	}
 
 	if (bDebugInterfaceWeights)
 	{
-		for (const auto& ScriptInterface : ScriptInterfaces)
+		const uint64 InterfaceKeyBase = KeyBase | (1ull << 31);
+
+		for (const auto& Binding : SinkBindings)
 		{
-			if (ScriptInterface.GetInterface() == nullptr)
+			const UObject* Object = Binding.Object.Get();
+
+			if (Object == nullptr)
 			{
 				continue;
 			}
-			
-			UObject* Object = ScriptInterface.GetObject();
 
-			if (Object != nullptr)
+			for (int32 Channel = 0; Channel < Binding.ChannelCount; Channel++)
 			{
-				FString Name = Object->GetFName().GetPlainNameString();
-				float Weight = 0.f;
-				ScriptInterface->GetWeight(Weight);
-				FString TruncatedValue = UKismetTextLibrary::Conv_FloatToText(Weight, ERoundingMode::HalfToEven, false, true, 1, 324, 0, 2).ToString();
-				FString Message = Name + ": " + TruncatedValue;
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, Message);				
+				const int32 OutputIndex = Binding.FirstChannel + Channel;
+
+				DebugMessage.Reset();
+				Object->GetFName().AppendString(DebugMessage);
+
+				if (Binding.Sink != nullptr)
+				{
+					DebugMessage.AppendChar(TEXT('['));
+					DebugMessage.AppendInt(Channel);
+					DebugMessage.AppendChar(TEXT(']'));
+				}
+
+				AppendDebugWeight(DebugMessage, OutputWeights[OutputIndex]);
+				GEngine->AddOnScreenDebugMessage(InterfaceKeyBase | OutputIndex, 1.0f, FColor::Green, DebugMessage);
 			}
 		}
 	}
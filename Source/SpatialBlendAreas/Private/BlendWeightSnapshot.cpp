@@ -0,0 +1,125 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendWeightSnapshot.h"
+
+FBlendWeightSnapshotBuffer::FBlendWeightSnapshotBuffer(const int32 InAreaCount)
+	: AreaCount(FMath::Max(InAreaCount, 0))
+{
+	// The slots are sized once here, so that publishing never reallocates memory a reader might be copying from.
+	for (FSlot& Slot : Slots)
+	{
+		Slot.Weights.SetNumZeroed(AreaCount);
+	}
+}
+
+void FBlendWeightSnapshotBuffer::Publish(const uint64 FrameNumber, TArrayView<const float> Weights)
+{
+	check(Weights.Num() == AreaCount);
+
+	const int32 CurrentSlot = LatestSlot.load(std::memory_order_relaxed);
+	const int32 NextSlot = CurrentSlot == INDEX_NONE ? 0 : (CurrentSlot + 1) % SlotCount;
+	FSlot& Slot = Slots[NextSlot];
+
+	// Mark the slot as being written (odd sequence) before touching its contents.
+	const uint32 Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+	Slot.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot.FrameNumber = FrameNumber;
+
+	if (AreaCount > 0)
+	{
+		FMemory::Memcpy(Slot.Weights.GetData(), Weights.GetData(), AreaCount * sizeof(float));
+	}
+
+	Slot.Sequence.store(Sequence + 2, std::memory_order_release);
+	LatestSlot.store(NextSlot, std::memory_order_release);
+}
+
+bool FBlendWeightSnapshotBuffer::Read(FBlendWeightSnapshot& OutSnapshot) const
+{
+	// Only grows the caller's array when needed, so a reused snapshot does not allocate.
+	OutSnapshot.Weights.SetNumUninitialized(AreaCount, false);
+
+	for (;;)
+	{
+		const int32 SlotIndex = LatestSlot.load(std::memory_order_acquire);
+
+		if (SlotIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FSlot& Slot = Slots[SlotIndex];
+		const uint32 SequenceBefore = Slot.Sequence.load(std::memory_order_acquire);
+
+		if (SequenceBefore % 2 == 1)
+		{
+			continue;
+		}
+
+		OutSnapshot.FrameNumber = Slot.FrameNumber;
+
+		if (AreaCount > 0)
+		{
+			FMemory::Memcpy(OutSnapshot.Weights.GetData(), Slot.Weights.GetData(), AreaCount * sizeof(float));
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (Slot.Sequence.load(std::memory_order_relaxed) == SequenceBefore)
+		{
+			return true;
+		}
+	}
+}
+
+bool FBlendWeightSnapshotBuffer::ReadWeight(const int32 AreaHandle, float& OutWeight, uint64* OutFrameNumber) const
+{
+	if (AreaHandle < 0 || AreaHandle >= AreaCount)
+	{
+		return false;
+	}
+
+	for (;;)
+	{
+		const int32 SlotIndex = LatestSlot.load(std::memory_order_acquire);
+
+		if (SlotIndex == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FSlot& Slot = Slots[SlotIndex];
+		const uint32 SequenceBefore = Slot.Sequence.load(std::memory_order_acquire);
+
+		if (SequenceBefore % 2 == 1)
+		{
+			continue;
+		}
+
+		const float Weight = Slot.Weights[AreaHandle];
+		const uint64 FrameNumber = Slot.FrameNumber;
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (Slot.Sequence.load(std::memory_order_relaxed) == SequenceBefore)
+		{
+			OutWeight = Weight;
+
+			if (OutFrameNumber != nullptr)
+			{
+				*OutFrameNumber = FrameNumber;
+			}
+
+			return true;
+		}
+	}
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendWeightTrace.h"
+#include "HAL/FileManager.h"
+
+bool FBlendWeightTrace::LoadFromFile(const FString& FilePath)
+{
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileReader(*FilePath));
+
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not open blend weight trace '%s'."), *FilePath)
+		return false;
+	}
+
+	uint32 FileMagic = 0;
+	uint32 FileVersion = 0;
+	int32 AreaCount = 0;
+	*Archive << FileMagic << FileVersion << AreaCount;
+
+	if (FileMagic != Magic || FileVersion != Version || AreaCount < 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("'%s' is not a supported blend weight trace."), *FilePath)
+		return false;
+	}
+
+	AreaNames.SetNum(AreaCount);
+
+	for (FString& AreaName : AreaNames)
+	{
+		*Archive << AreaName;
+	}
+
+	Positions.Reset();
+	Weights.Reset();
+	TArray<uint16> QuantizedWeights;
+	QuantizedWeights.SetNumUninitialized(AreaCount);
+
+	while (!Archive->AtEnd() && !Archive->IsError())
+	{
+		FVector Position;
+		*Archive << Position;
+		Archive->Serialize(QuantizedWeights.GetData(), AreaCount * sizeof(uint16));
+
+		if (Archive->IsError())
+		{
+			break;
+		}
+
+		Positions.Add(Position);
+
+		for (const uint16 QuantizedWeight : QuantizedWeights)
+		{
+			Weights.Add(static_cast<float>(QuantizedWeight) / MAX_uint16);
+		}
+	}
+
+	return true;
+}
+
+FBlendWeightTraceWriter::~FBlendWeightTraceWriter()
+{
+	Close();
+}
+
+bool FBlendWeightTraceWriter::Open(const FString& FilePath, TArrayView<const FString> AreaNames)
+{
+	Close();
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*FilePath));
+
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Could not create blend weight trace '%s'."), *FilePath)
+		return false;
+	}
+
+	uint32 Magic = FBlendWeightTrace::Magic;
+	uint32 Version = FBlendWeightTrace::Version;
+	int32 AreaCount = AreaNames.Num();
+	*Archive << Magic << Version << AreaCount;
+
+	for (const FString& AreaName : AreaNames)
+	{
+		FString Name = AreaName;
+		*Archive << Name;
+	}
+
+	QuantizedWeights.SetNumUninitialized(AreaCount);
+	return true;
+}
+
+void FBlendWeightTraceWriter::WriteFrame(const FVector& Position, TArrayView<const float> Weights)
+{
+	if (!Archive.IsValid() || Weights.Num() != QuantizedWeights.Num())
+	{
+		return;
+	}
+
+	FVector FramePosition = Position;
+	*Archive << FramePosition;
+
+	for (int32 Index = 0; Index < Weights.Num(); Index++)
+	{
+		QuantizedWeights[Index] = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Weights[Index], 0.f, 1.f) * MAX_uint16));
+	}
+
+	Archive->Serialize(QuantizedWeights.GetData(), QuantizedWeights.Num() * sizeof(uint16));
+}
+
+void FBlendWeightTraceWriter::Close()
+{
+	if (Archive.IsValid())
+	{
+		Archive->Close();
+		Archive.Reset();
+	}
+}
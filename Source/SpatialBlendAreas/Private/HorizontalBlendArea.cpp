@@ -9,6 +9,8 @@ subjected to the respective product licensing terms.
 ******************************************************************************************************/
 
 #include "HorizontalBlendArea.h"
+#include "Algo/Sort.h"
+#include "Components/LineBatchComponent.h"
 
 AHorizontalBlendArea::AHorizontalBlendArea()
 {
@@ -24,69 +26,292 @@ void AHorizontalBlendArea::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+void AHorizontalBlendArea::InitializeArea()
+{
+	Super::InitializeArea();
+	FullWeight = FalloffTable.IsValid() ? FalloffTable->Evaluate(1.f) : 1.f;
+	BuildInsetPolygon();
+}
+
+void AHorizontalBlendArea::BuildInsetPolygon()
+{
+	InsetEdges.Reset();
+	InsetBounds = FBox2D(ForceInit);
+
+	if (BlendDistance <= 0 || Edges.Num() < 3)
+	{
+		return;
+	}
+
+	TArray<FVector2D> InsetPoints;
+	InsetPoints.SetNumUninitialized(Points.Num());
+
+	for (int32 Ring = 0; Ring < GetRingCount(); Ring++)
+	{
+		const int32 RingStart = RingOffsets[Ring];
+		const int32 RingCount = RingOffsets[Ring + 1] - RingStart;
+
+		double TwiceSignedArea = 0.0;
+
+		for (int32 Index = 0; Index < RingCount; Index++)
+		{
+			TwiceSignedArea += FVector2D::CrossProduct(Points[RingStart + Index], Points[RingStart + (Index + 1) % RingCount]);
+		}
+
+		if (TwiceSignedArea == 0.0)
+		{
+			return;
+		}
+
+		// The filled region is on the left side of a counterclockwise outer ring and on the right side of a counterclockwise hole.
+		const double InwardSign = (TwiceSignedArea > 0.0) == (Ring == 0) ? 1.0 : -1.0;
+
+		for (int32 Index = 0; Index < RingCount; Index++)
+		{
+			const FVector2D& Previous = Points[RingStart + (Index + RingCount - 1) % RingCount];
+			const FVector2D& Current = Points[RingStart + Index];
+			const FVector2D& Next = Points[RingStart + (Index + 1) % RingCount];
+
+			const FVector2D PreviousDirection = (Current - Previous).GetSafeNormal();
+			const FVector2D NextDirection = (Next - Current).GetSafeNormal();
+
+			if (PreviousDirection.IsZero() || NextDirection.IsZero())
+			{
+				return;
+			}
+
+			const FVector2D PreviousNormal = InwardSign * FVector2D(-PreviousDirection.Y, PreviousDirection.X);
+			const FVector2D NextNormal = InwardSign * FVector2D(-NextDirection.Y, NextDirection.X);
+			const double Denominator = 1.0 + (PreviousNormal | NextNormal);
+
+			// The edges fold back onto each other, the miter would be unbounded.
+			if (Denominator < KINDA_SMALL_NUMBER)
+			{
+				return;
+			}
+
+			// The miter point is exact at convex corners and lies beyond the rounded offset at reflex corners,
+			// so the inset never contains points closer than 'BlendDistance' to the boundary.
+			InsetPoints[RingStart + Index] = Current + (PreviousNormal + NextNormal) * (BlendDistance / Denominator);
+		}
+	}
+
+	TArray<FEdge> NewEdges;
+	NewEdges.Reserve(Edges.Num());
+
+	for (int32 Ring = 0; Ring < GetRingCount(); Ring++)
+	{
+		const int32 RingStart = RingOffsets[Ring];
+		const int32 RingEnd = RingOffsets[Ring + 1];
+
+		for (int32 Index = RingStart; Index < RingEnd; Index++)
+		{
+			const FEdge InsetEdge = { InsetPoints[Index], InsetPoints[Index == RingEnd - 1 ? RingStart : Index + 1] };
+
+			// An edge pointing the other way has been consumed by its neighbours, i.e. the band collapses there.
+			if (((InsetEdge.End - InsetEdge.Start) | (Edges[Index].End - Edges[Index].Start)) <= 0.0)
+			{
+				return;
+			}
+
+			NewEdges.Add(InsetEdge);
+		}
+	}
+
+	if (HasCrossingEdges(NewEdges))
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("The blend band of '%s' overlaps itself, full weight queries are not short-circuited."), *GetName())
+		return;
+	}
+
+	InsetEdges = MoveTemp(NewEdges);
+	InsetBounds = FBox2D(InsetPoints.GetData(), RingOffsets[1]);
+}
+
+bool AHorizontalBlendArea::HasCrossingEdges(TArrayView<const FEdge> InEdges) const
+{
+	// Sweep the edges along the X-axis, so that only edges with overlapping X-ranges are tested against each other.
+	TArray<int32> Order;
+	Order.Reserve(InEdges.Num());
+
+	for (int32 Index = 0; Index < InEdges.Num(); Index++)
+	{
+		Order.Add(Index);
+	}
+
+	Algo::SortBy(Order, [&InEdges](const int32 Index) { return FMath::Min(InEdges[Index].Start.X, InEdges[Index].End.X); });
+
+	for (int32 OrderA = 0; OrderA < Order.Num(); OrderA++)
+	{
+		const FEdge& A = InEdges[Order[OrderA]];
+		const double MaxXA = FMath::Max(A.Start.X, A.End.X);
+
+		for (int32 OrderB = OrderA + 1; OrderB < Order.Num(); OrderB++)
+		{
+			const FEdge& B = InEdges[Order[OrderB]];
+
+			if (FMath::Min(B.Start.X, B.End.X) > MaxXA)
+			{
+				break;
+			}
+
+			if (FMath::Max(A.Start.Y, A.End.Y) < FMath::Min(B.Start.Y, B.End.Y) ||
+				FMath::Max(B.Start.Y, B.End.Y) < FMath::Min(A.Start.Y, A.End.Y))
+			{
+				continue;
+			}
+
+			// Neighbouring edges of a ring share a vertex, which is not a crossing.
+			if (A.End == B.Start || B.End == A.Start)
+			{
+				continue;
+			}
+
+			const double SideB1 = FVector2D::CrossProduct(A.End - A.Start, B.Start - A.Start);
+			const double SideB2 = FVector2D::CrossProduct(A.End - A.Start, B.End - A.Start);
+			const double SideA1 = FVector2D::CrossProduct(B.End - B.Start, A.Start - B.Start);
+			const double SideA2 = FVector2D::CrossProduct(B.End - B.Start, A.End - B.Start);
+
+			// Touching counts as crossing, which only errs on the side of not using the inset.
+			if (SideB1 * SideB2 <= 0.0 && SideA1 * SideA2 <= 0.0)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 float AHorizontalBlendArea::GetBlendWeight(const FVector& Point) const 
 {
-	if (!IsInside(Point))
+	const FVector2D Point2D = FVector2D(Point.X, Point.Y);
+
+	// Points inside the inset are at least 'BlendDistance' from the boundary, so the containment test
+	// against the inset alone decides the weight. The area itself does not need to be tested at all.
+	if (InsetEdges.Num() > 0 && InsetBounds.IsInside(Point2D) && IsInsideEdges(InsetEdges, Point2D))
+	{
+		return FullWeight;
+	}
+
+	if (BlendDistance <= 0)
+	{
+		return IsInside(Point2D) ? 1 : 0;
+	}
+
+	// Containment and the boundary within 'BlendDistance' in one pass over the edges.
+	const double BlendDistanceSquared = FMath::Square(BlendDistance);
+	FWorldAreaSignedDistance Distance;
+
+	if (!GetSignedDistance(Point2D, Distance, BlendDistanceSquared) || !Distance.bIsInside)
 	{
 		return 0;
 	}
+
+	return GetBlendWeightAtDistanceSquared(Distance.DistanceSquared);
+}
+
+float AHorizontalBlendArea::GetBlendWeightContained(const FVector& Point) const
+{
+	const FVector2D Point2D = FVector2D(Point.X, Point.Y);
+
+	if (InsetEdges.Num() > 0 && InsetBounds.IsInside(Point2D) && IsInsideEdges(InsetEdges, Point2D))
+	{
+		return FullWeight;
+	}
+
+	return GetBlendWeightInside(Point2D);
+}
+
+float AHorizontalBlendArea::GetBlendWeightInside(const FVector2D& Point) const
+{
 	if (BlendDistance <= 0)
 	{
 		return 1;
 	}
 
-	const FVector2D Point2D = FVector2D(Point.X, Point.Y);
+	// Only the boundary within 'BlendDistance' affects the weight. If there is none, the point is in the full weight region.
+	const double BlendDistanceSquared = FMath::Square(BlendDistance);
 	FVector2D ClosestPoint;
-	double DistanceSquared = 0.0;
-	GetClosestPointAndDistanceSquared(Point2D, ClosestPoint, DistanceSquared);
-	double BlendDistanceSquared = FMath::Square(BlendDistance);
-	return FMath::Clamp(DistanceSquared / BlendDistanceSquared, 0, 1);
+	double DistanceSquared = BlendDistanceSquared;
+	GetClosestPointAndDistanceSquared(Point, BlendDistanceSquared, ClosestPoint, DistanceSquared);
+	return GetBlendWeightAtDistanceSquared(DistanceSquared);
+}
+
+float AHorizontalBlendArea::GetBlendWeightAtDistanceSquared(const double DistanceSquared) const
+{
+	const float Alpha = FMath::Clamp(DistanceSquared / FMath::Square(BlendDistance), 0, 1);
+	return FalloffTable.IsValid() ? FalloffTable->Evaluate(Alpha) : Alpha;
 }
 
 #if WITH_EDITOR
 
-void AHorizontalBlendArea::DebugDraw() const
+void AHorizontalBlendArea::AppendDebugLines(TArray<FBatchedLine>& OutLines, TArray<FBatchedPoint>& OutPoints) const
+{
+	Super::AppendDebugLines(OutLines, OutPoints);
+
+	// Outline the full weight region, where queries are decided by the inset containment test alone.
+	if (bEditorDebugHorizontalBlend)
+	{
+		for (const FEdge& Edge : InsetEdges)
+		{
+			OutLines.Emplace(FVector(Edge.Start.X, Edge.Start.Y, EditorDrawHeight), FVector(Edge.End.X, Edge.End.Y, EditorDrawHeight),
+							 FColor::Green, 0.f, 0.f, SDPG_World);
+		}
+	}
+}
+
+bool AHorizontalBlendArea::HasDynamicDebugDraw() const
 {
-	Super::DebugDraw();
+	return bEditorDebugHorizontalBlend && TestActor != nullptr;
+}
 
+void AHorizontalBlendArea::DrawDynamicDebug() const
+{
 	if (bEditorDebugHorizontalBlend && TestActor->IsValidLowLevel())
 	{
 		const FVector Location = TestActor->GetActorLocation();
 		const FVector2D Location2D = FVector2D(Location.X, Location.Y);
 
-		if (IsInside(Location2D))
+		FWorldAreaSignedDistance SignedDistance;
+
+		if (GetSignedDistance(Location2D, SignedDistance) && SignedDistance.bIsInside && SignedDistance.bHasClosestPoint)
 		{
-			const float BlendWeight = GetBlendWeight(Location);
-			FVector2D ClosestPoint;
-			double DistanceSquared = 0.0;
+			const FVector2D& ClosestPoint = SignedDistance.ClosestPoint;
+			const double Distance = -SignedDistance.SignedDistance;
+			const FVector2D Direction = (Location2D - ClosestPoint).GetSafeNormal();
+			const double BlendDist = BlendDistance >= 0 ? BlendDistance : 0.;
+			const FVector2D FullWeightPosition = ClosestPoint + Direction * BlendDist;
 
-			if (GetClosestPointAndDistanceSquared(Location2D, ClosestPoint, DistanceSquared))
+			if (Distance >= BlendDist)
 			{
-				const double Distance = FMath::Sqrt(DistanceSquared);
-				const FVector2D Direction = (Location2D - ClosestPoint).GetSafeNormal();
-				const double BlendDist = BlendDistance >= 0 ? BlendDistance : 0.;
-				const FVector2D FullWeightPosition = ClosestPoint + Direction * BlendDist;
-
-				if (Distance >= BlendDist)
-				{
-					DrawDebugLine(this->GetWorld(), FVector(ClosestPoint.X, ClosestPoint.Y, EditorDrawHeight), 
-													FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight), FColor::Green);
-
-					DrawDebugLine(this->GetWorld(), FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight),
-													FVector(Location2D.X, Location2D.Y, EditorDrawHeight), FColor::Transparent);
-				}
-				else
-				{
-					DrawDebugLine(this->GetWorld(), FVector(ClosestPoint.X, ClosestPoint.Y, EditorDrawHeight),
-													FVector(Location2D.X, Location2D.Y, EditorDrawHeight), FColor::Green);
-
-					DrawDebugLine(this->GetWorld(), FVector(Location2D.X, Location2D.Y, EditorDrawHeight),
-													FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight), FColor::Red);
-				}
-
-				DrawDebugPoint(this->GetWorld(), FVector(Location2D.X, Location2D.Y, EditorDrawHeight), 10.f, FColor::White);
+				DrawDebugLine(this->GetWorld(), FVector(ClosestPoint.X, ClosestPoint.Y, EditorDrawHeight), 
+												FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight), FColor::Green);
+
+				DrawDebugLine(this->GetWorld(), FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight),
+												FVector(Location2D.X, Location2D.Y, EditorDrawHeight), FColor::Transparent);
+			}
+			else
+			{
+				DrawDebugLine(this->GetWorld(), FVector(ClosestPoint.X, ClosestPoint.Y, EditorDrawHeight),
+												FVector(Location2D.X, Location2D.Y, EditorDrawHeight), FColor::Green);
+
+				DrawDebugLine(this->GetWorld(), FVector(Location2D.X, Location2D.Y, EditorDrawHeight),
+												FVector(FullWeightPosition.X, FullWeightPosition.Y, EditorDrawHeight), FColor::Red);
 			}
+
+			DrawDebugPoint(this->GetWorld(), FVector(Location2D.X, Location2D.Y, EditorDrawHeight), 10.f, FColor::White);
 		}
 	}
 }
 #endif
+
+void AHorizontalBlendArea::EvaluateBatch(TArrayView<const AHorizontalBlendArea* const> InAreas, const FVector& Point, TArrayView<float> OutWeights)
+{
+	check(InAreas.Num() == OutWeights.Num());
+
+	for (int32 Index = 0; Index < InAreas.Num(); Index++)
+	{
+		OutWeights[Index] = InAreas[Index] != nullptr ? InAreas[Index]->AHorizontalBlendArea::GetBlendWeight(Point) : 0.f;
+	}
+}
@@ -0,0 +1,73 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "BlendAreaSubsystem.h"
+#include "HorizontalBlendArea.h"
+#include "BlendWeightTestHelpers.h"
+#include "BlendWeightTestTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlendAreaRegisterBeforeInitializeTest, "SpatialBlendAreas.BlendAreaSubsystem.RegisterBeforeInitialize",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/**
+* A manager registers its areas with the subsystem in PostInitializeComponents(), before the subsystem initializes
+* them at the start of play, so they have no bounds to be indexed with yet. Once play has begun, the areas must be
+* found by the arrangement grid and the bounds tree, and weigh in through the shared evaluation path.
+*/
+bool FBlendAreaRegisterBeforeInitializeTest::RunTest(const FString& Parameters)
+{
+	using namespace BlendWeightTests;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	TSet<const ABlendArea*> Areas;
+
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		Areas.Add(SpawnArea(World, FVector2D(Index * 4000.0, 0.0), 1000.0, 0));
+	}
+
+	ABlendWeightTestManager* Manager = World->SpawnActor<ABlendWeightTestManager>();
+	Manager->Sink->AddChannels(Areas);
+
+	BeginPlay(World);
+
+	UBlendAreaSubsystem* Subsystem = World->GetSubsystem<UBlendAreaSubsystem>();
+	int32 Channel = 0;
+
+	for (const ABlendArea* Area : Areas)
+	{
+		const FVector Center = FVector(Area->GetBounds().GetCenter(), 0.0);
+		const int32 AreaIndex = Subsystem->GetAreaIndex(Area);
+		TestTrue(TEXT("The area is registered"), AreaIndex != INDEX_NONE);
+
+		const TArrayView<const FBlendAreaCandidate> Candidates = Subsystem->GetCandidates(Subsystem->FindOrAddPosition(Center));
+		TestTrue(TEXT("The arrangement grid finds the area at its center"),
+				 Candidates.ContainsByPredicate([AreaIndex](const FBlendAreaCandidate& Candidate) { return Candidate.AreaIndex == AreaIndex; }));
+
+		TArray<FBlendAreaDistance> Nearest;
+		Subsystem->FindNearestAreas(Area->GetBounds().GetCenter(), 1, Nearest);
+		TestTrue(TEXT("The bounds tree finds the area at its center"), Nearest.Num() == 1 && Nearest[0].Area == Area);
+
+		Manager->BlendPosition = Center;
+		Manager->Tick(0.f);
+		TestEqual(TEXT("The weight of the area at its center"), Manager->Sink->Weights.IsValidIndex(Channel) ? Manager->Sink->Weights[Channel] : 0.f, 1.f);
+		Channel++;
+	}
+
+	DestroyWorld(World);
+	return true;
+}
+
+#endif
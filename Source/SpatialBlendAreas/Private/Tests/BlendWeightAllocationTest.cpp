@@ -0,0 +1,105 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "BlendAreaSubsystem.h"
+#include "BlendWeightDistributor.h"
+#include "BlendWeightTestHelpers.h"
+#include "BlendWeightTestTypes.h"
+#include "HorizontalBlendArea.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlendWeightSteadyStateAllocationTest, "SpatialBlendAreas.BlendWeights.SteadyStateAllocations",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/**
+* Ticks weight managers along a path that crosses overlapping areas: one dispatching every evaluation to its sink
+* with the on-screen weight debugging enabled, and one with smoothing and a time budget. Alongside, bare distributors
+* run the linear, shared and time budgeted evaluation paths. The areas and managers begin play in the order a loaded
+* map goes through. After one warm-up pass over the path has sized all scratch and caches, a second pass over it
+* must not allocate.
+*/
+bool FBlendWeightSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace BlendWeightTests;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	TSet<const ABlendArea*> Areas;
+
+	for (int32 Index = 0; Index < 8; Index++)
+	{
+		Areas.Add(SpawnArea(World, FVector2D(Index * 1500.0, (Index % 2) * 500.0), 1000.0, Index % 3));
+	}
+
+	ABlendWeightTestManager* DispatchingManager = World->SpawnActor<ABlendWeightTestManager>();
+	DispatchingManager->Sink->AddChannels(Areas);
+	SetBoolProperty(DispatchingManager, TEXT("bDebugBlendAreaWeights"), true);
+	SetBoolProperty(DispatchingManager, TEXT("bDebugInterfaceWeights"), true);
+
+	ABlendWeightTestManager* SmoothingManager = World->SpawnActor<ABlendWeightTestManager>();
+	SmoothingManager->Sink->AddChannels(Areas);
+	SmoothingManager->SetEvaluationOptions(0.2f, 50.f);
+
+	BeginPlay(World);
+
+	UBlendAreaSubsystem* Subsystem = World->GetSubsystem<UBlendAreaSubsystem>();
+
+	UBlendWeightDistributor* LinearDistributor = NewObject<UBlendWeightDistributor>();
+	LinearDistributor->Initialize(Areas);
+
+	UBlendWeightDistributor* SharedDistributor = NewObject<UBlendWeightDistributor>();
+	SharedDistributor->Initialize(Areas, Subsystem);
+
+	UBlendWeightDistributor* BudgetedDistributor = NewObject<UBlendWeightDistributor>();
+	BudgetedDistributor->Initialize(Areas);
+	BudgetedDistributor->SetTimeBudget(50.f);
+
+	UBlendWeightDistributor* SharedBudgetedDistributor = NewObject<UBlendWeightDistributor>();
+	SharedBudgetedDistributor->Initialize(Areas, Subsystem);
+	SharedBudgetedDistributor->SetTimeBudget(50.f);
+
+	TArray<FVector> Path;
+
+	for (int32 Step = 0; Step < 256; Step++)
+	{
+		Path.Emplace(-2000.0 + Step * 60.0, FMath::Sin(Step * 0.1) * 1200.0, 0.0);
+	}
+
+	auto RunPath = [&]()
+	{
+		for (const FVector& Position : Path)
+		{
+			// Every step stands for a frame of its own, as it does for the evaluation cache of the subsystem.
+			Subsystem->InvalidateCache();
+			LinearDistributor->UpdateWeightData(Position);
+			SharedDistributor->UpdateWeightData(Position);
+			BudgetedDistributor->UpdateWeightData(Position);
+			SharedBudgetedDistributor->UpdateWeightData(Position);
+
+			DispatchingManager->BlendPosition = Position;
+			DispatchingManager->Tick(1.f / 60.f);
+			SmoothingManager->BlendPosition = Position;
+			SmoothingManager->Tick(1.f / 60.f);
+		}
+	};
+
+	RunPath();
+
+	TestEqual(TEXT("Allocations during the steady-state ticks"), CountAllocations(RunPath), 0);
+	TestTrue(TEXT("The managers dispatched weights"), DispatchingManager->Sink->Weights.Num() == Areas.Num() && SmoothingManager->Sink->Weights.Num() == Areas.Num());
+
+	DestroyWorld(World);
+	return true;
+}
+
+#endif
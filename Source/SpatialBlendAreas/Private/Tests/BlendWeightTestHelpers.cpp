@@ -0,0 +1,92 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendWeightTestHelpers.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/WorldSettings.h"
+#include "HorizontalBlendArea.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace BlendWeightTests
+{
+	AHorizontalBlendArea* SpawnArea(UWorld* World, const FVector2D& Center, const double HalfSize, const uint32 Priority)
+	{
+		AHorizontalBlendArea* Area = World->SpawnActor<AHorizontalBlendArea>();
+		USplineComponent* Spline = Area->FindComponentByClass<USplineComponent>();
+
+		Spline->SetSplinePoints(TArray<FVector>(
+		{
+			FVector(Center.X - HalfSize, Center.Y - HalfSize, 0.0),
+			FVector(Center.X + HalfSize, Center.Y - HalfSize, 0.0),
+			FVector(Center.X + HalfSize, Center.Y + HalfSize, 0.0),
+			FVector(Center.X - HalfSize, Center.Y + HalfSize, 0.0)
+		}), ESplineCoordinateSpace::World, false);
+
+		for (int32 Index = 0; Index < Spline->GetNumberOfSplinePoints(); Index++)
+		{
+			Spline->SetSplinePointType(Index, ESplinePointType::Linear, false);
+		}
+
+		Spline->UpdateSpline();
+
+		// A blend distance, so that the evaluations also take the boundary distance path.
+		if (FDoubleProperty* BlendDistance = FindFProperty<FDoubleProperty>(ABlendArea::StaticClass(), TEXT("BlendDistance")))
+		{
+			BlendDistance->SetPropertyValue_InContainer(Area, HalfSize * 0.5);
+		}
+
+		Area->Priority = Priority;
+		return Area;
+	}
+
+	void BeginPlay(UWorld* World)
+	{
+		// Runs PostInitializeComponents() on the actors spawned so far, before the subsystems begin play.
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		// Without a game mode, nothing starts the actors; the world settings do it as the game mode would.
+		if (!World->HasBegunPlay())
+		{
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+	}
+
+	void DestroyWorld(UWorld* World)
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			It->RouteEndPlay(EEndPlayReason::Destroyed);
+		}
+
+		World->DestroyWorld(false);
+	}
+
+	void SetBoolProperty(UObject* Object, const FName PropertyName, const bool bValue)
+	{
+		if (FBoolProperty* Property = FindFProperty<FBoolProperty>(Object->GetClass(), PropertyName))
+		{
+			Property->SetPropertyValue_InContainer(Object, bValue);
+		}
+	}
+
+	void SetObjectProperty(UObject* Object, const FName PropertyName, UObject* Value)
+	{
+		if (FObjectProperty* Property = FindFProperty<FObjectProperty>(Object->GetClass(), PropertyName))
+		{
+			Property->SetObjectPropertyValue_InContainer(Object, Value);
+		}
+	}
+}
+
+#endif
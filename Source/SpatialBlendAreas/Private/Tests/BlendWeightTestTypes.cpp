@@ -0,0 +1,36 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendWeightTestTypes.h"
+
+void UBlendWeightTestSink::SetWeights(TArrayView<const float> InWeights)
+{
+	Weights.SetNumUninitialized(InWeights.Num(), false);
+	FMemory::Memcpy(Weights.GetData(), InWeights.GetData(), InWeights.Num() * sizeof(float));
+}
+
+void UBlendWeightTestSink::AddChannels(const TSet<const ABlendArea*>& Areas)
+{
+	for (const ABlendArea* Area : Areas)
+	{
+		ChannelAreas.Add({ Area });
+	}
+}
+
+ABlendWeightTestManager::ABlendWeightTestManager()
+{
+	Sink = CreateDefaultSubobject<UBlendWeightTestSink>("Sink");
+}
+
+void ABlendWeightTestManager::SetEvaluationOptions(const float InSmoothingTimeConstant, const float InEvaluationBudgetMicroseconds)
+{
+	SmoothingTimeConstant = InSmoothingTimeConstant;
+	EvaluationBudgetMicroseconds = InEvaluationBudgetMicroseconds;
+}
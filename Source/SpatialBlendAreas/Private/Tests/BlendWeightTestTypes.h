@@ -0,0 +1,61 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "BlendWeightManager.h"
+#include "BlendWeightSink.h"
+#include "BlendWeightTestTypes.generated.h"
+
+/** A sink with a channel per blend area, keeping the weights it was last handed. Only used by the automation tests. */
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class UBlendWeightTestSink : public UActorComponent, public IBlendWeightSink
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual int32 GetChannelCount() const override { return ChannelAreas.Num(); }
+	const virtual TSet<const ABlendArea*>& GetChannelBlendAreas(const int32 Channel) const override { return ChannelAreas[Channel]; }
+	virtual void SetWeights(TArrayView<const float> InWeights) override;
+
+	/** Adds a channel for each area. Call before the owning manager initializes its components. */
+	void AddChannels(const TSet<const ABlendArea*>& Areas);
+
+	TArray<TSet<const ABlendArea*>> ChannelAreas;
+
+	/** The weights of the latest SetWeights() call, sized on the first call. */
+	TArray<float> Weights;
+};
+
+/** A manager that follows a position set by the test instead of an audio listener. Only used by the automation tests. */
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class ABlendWeightTestManager : public ABlendWeightManager
+{
+	GENERATED_BODY()
+
+public:
+
+	ABlendWeightTestManager();
+
+	/** Sets the evaluation options that are otherwise only edited on the manager instance. Call before initialization. */
+	void SetEvaluationOptions(const float InSmoothingTimeConstant, const float InEvaluationBudgetMicroseconds);
+
+	UPROPERTY()
+	UBlendWeightTestSink* Sink;
+
+	FVector BlendPosition = FVector::ZeroVector;
+
+protected:
+
+	virtual void GetBlendPosition(FVector& OutPosition) const override { OutPosition = BlendPosition; }
+};
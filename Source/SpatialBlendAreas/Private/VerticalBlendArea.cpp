@@ -9,6 +9,12 @@ subjected to the respective product licensing terms.
 ******************************************************************************************************/
 
 #include "VerticalBlendArea.h"
+#include "Components/LineBatchComponent.h"
+#include "Engine/World.h"
+
+#if WITH_EDITOR
+#include "LandscapeProxy.h"
+#endif
 
 AVerticalBlendArea::AVerticalBlendArea()
 	:BlendStartHeight(0.)
@@ -25,31 +31,89 @@ void AVerticalBlendArea::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+void AVerticalBlendArea::InitializeArea()
+{
+	Super::InitializeArea();
+
+	if (bUseStartHeightField && !HasStartHeightField())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("VerticalBlendArea '%s' has no baked start heightfield, using the constant BlendStartHeight."), *GetName())
+	}
+}
+
+bool AVerticalBlendArea::HasStartHeightField() const
+{
+	return bUseStartHeightField && StartHeightFieldResolution.X >= 2 && StartHeightFieldResolution.Y >= 2 &&
+		   StartHeightField.Num() == StartHeightFieldResolution.X * StartHeightFieldResolution.Y;
+}
+
+double AVerticalBlendArea::GetBlendStartHeight(const FVector2D& Point) const
+{
+	if (!HasStartHeightField())
+	{
+		return BlendStartHeight;
+	}
+
+	// Bilinear interpolation between the four samples around the point, clamped to the edges of the heightfield.
+	const double GridX = FMath::Clamp((Point.X - StartHeightFieldOrigin.X) / StartHeightFieldSpacing, 0.0, StartHeightFieldResolution.X - 1.0);
+	const double GridY = FMath::Clamp((Point.Y - StartHeightFieldOrigin.Y) / StartHeightFieldSpacing, 0.0, StartHeightFieldResolution.Y - 1.0);
+	const int32 X0 = FMath::Min(static_cast<int32>(GridX), StartHeightFieldResolution.X - 2);
+	const int32 Y0 = FMath::Min(static_cast<int32>(GridY), StartHeightFieldResolution.Y - 2);
+	const int32 Index = Y0 * StartHeightFieldResolution.X + X0;
+
+	const double Height = FMath::BiLerp<double>(StartHeightField[Index], StartHeightField[Index + 1],
+												StartHeightField[Index + StartHeightFieldResolution.X],
+												StartHeightField[Index + StartHeightFieldResolution.X + 1],
+												GridX - X0, GridY - Y0);
+
+	return Height + BlendStartHeight;
+}
+
 float AVerticalBlendArea::GetBlendWeight(const FVector& Point) const
 {
-	if (!IsInside(Point))
+	const double& Height = Point.Z;
+
+	// The height tests are cheaper than the XY containment test, so queries below the area exit first.
+	if (Height < (HasStartHeightField() ? StartHeightFieldMin + BlendStartHeight : BlendStartHeight))
 	{
 		return 0;
 	}
 
-	const double& Height = Point.Z;
+	const double StartHeight = GetBlendStartHeight(FVector2D(Point.X, Point.Y));
 
-	if (Height < BlendStartHeight)
+	if (Height < StartHeight)
+	{
+		return 0;
+	}
+
+	if (!IsInside(Point))
 	{
 		return 0;
 	}
-	
+
+	return GetBlendWeightAtHeight(Height, StartHeight);
+}
+
+float AVerticalBlendArea::GetBlendWeightContained(const FVector& Point) const
+{
+	const double StartHeight = GetBlendStartHeight(FVector2D(Point.X, Point.Y));
+	return Point.Z < StartHeight ? 0.f : GetBlendWeightAtHeight(Point.Z, StartHeight);
+}
+
+float AVerticalBlendArea::GetBlendWeightAtHeight(const double Height, const double StartHeight) const
+{
 	const double BlendDist = BlendDistance >= 0 ? BlendDistance : 0.;
-	const double BlendMaxHeight = BlendStartHeight + BlendDist;
+	const double BlendMaxHeight = StartHeight + BlendDist;
 
 	if (Height >= BlendMaxHeight)
 	{
-		return 1;
+		return FalloffTable.IsValid() ? FalloffTable->Evaluate(1.f) : 1;
 	}
 
 	if (BlendDist > 0)
 	{
-		return (Height - BlendStartHeight) / BlendDist;
+		const float Alpha = (Height - StartHeight) / BlendDist;
+		return FalloffTable.IsValid() ? FalloffTable->Evaluate(Alpha) : Alpha;
 	}
 
 	return 1;
@@ -57,21 +121,116 @@ float AVerticalBlendArea::GetBlendWeight(const FVector& Point) const
 
 #if WITH_EDITOR
 
-void AVerticalBlendArea::DebugDraw() const
+void AVerticalBlendArea::AppendDebugLines(TArray<FBatchedLine>& OutLines, TArray<FBatchedPoint>& OutPoints) const
 {
-	Super::DebugDraw();
+	Super::AppendDebugLines(OutLines, OutPoints);
 
 	if (bEditorDebugVerticalBlend)
 	{
 		for (const auto& Point : Points)
 		{
-			FVector Min = FVector(Point.X, Point.Y, BlendStartHeight);
-			FVector Max = FVector(Point.X, Point.Y, BlendStartHeight + (BlendDistance >= 0 ? BlendDistance : 0.0));
+			const double StartHeight = GetBlendStartHeight(Point);
+			FVector Min = FVector(Point.X, Point.Y, StartHeight);
+			FVector Max = FVector(Point.X, Point.Y, StartHeight + (BlendDistance >= 0 ? BlendDistance : 0.0));
 
-			DrawDebugLine(this->GetWorld(), Min, Max, EditorDebugBlendColor);
-			DrawDebugPoint(this->GetWorld(), Min, 10.f, EditorDebugBlendColor);
-			DrawDebugPoint(this->GetWorld(), Max, 10.f, EditorDebugBlendColor);
+			OutLines.Emplace(Min, Max, EditorDebugBlendColor, 0.f, 0.f, SDPG_World);
+			OutPoints.Emplace(Min, EditorDebugBlendColor, 10.f, 0.f, SDPG_World);
+			OutPoints.Emplace(Max, EditorDebugBlendColor, 10.f, 0.f, SDPG_World);
 		}
 	}
 }
+
+void AVerticalBlendArea::BakeStartHeightField()
+{
+	UWorld* World = GetWorld();
+
+	if (World == nullptr)
+	{
+		return;
+	}
+
+	InitializeArea();
+
+	if (!Bounds.bIsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cannot bake the start heightfield of '%s' without a valid area."), *GetName())
+		return;
+	}
+
+	const FVector2D Size = Bounds.GetSize();
+	const double Spacing = FMath::Max3(StartHeightFieldCellSize, Size.X / (MaxStartHeightFieldResolution - 1), Size.Y / (MaxStartHeightFieldResolution - 1));
+	const FIntPoint Resolution(FMath::CeilToInt(Size.X / Spacing) + 1, FMath::CeilToInt(Size.Y / Spacing) + 1);
+
+	TArray<float> Heights;
+	Heights.Reserve(Resolution.X * Resolution.Y);
+	TBitArray<> Sampled;
+
+	double MinHeight = TNumericLimits<double>::Max();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(BakeStartHeightField), true, this);
+
+	for (int32 Y = 0; Y < Resolution.Y; Y++)
+	{
+		for (int32 X = 0; X < Resolution.X; X++)
+		{
+			const FVector2D Sample = Bounds.Min + FVector2D(X, Y) * Spacing;
+			const FVector Start = FVector(Sample.X, Sample.Y, HALF_WORLD_MAX);
+			const FVector End = FVector(Sample.X, Sample.Y, -HALF_WORLD_MAX);
+
+			TArray<FHitResult> Hits;
+			World->LineTraceMultiByObjectType(Hits, Start, End, FCollisionObjectQueryParams(ECC_WorldStatic), QueryParams);
+
+			// Only the landscape defines the terrain; props and buildings standing on it are skipped.
+			const FHitResult* LandscapeHit = Hits.FindByPredicate([](const FHitResult& Hit)
+			{
+				return Cast<ALandscapeProxy>(Hit.GetActor()) != nullptr;
+			});
+
+			Heights.Add(LandscapeHit != nullptr ? static_cast<float>(LandscapeHit->ImpactPoint.Z) : 0.f);
+			Sampled.Add(LandscapeHit != nullptr);
+
+			if (LandscapeHit != nullptr)
+			{
+				MinHeight = FMath::Min(MinHeight, LandscapeHit->ImpactPoint.Z);
+			}
+		}
+	}
+
+	Modify();
+
+	if (MinHeight == TNumericLimits<double>::Max())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No landscape found under '%s', the start heightfield was not baked."), *GetName())
+		StartHeightField.Reset();
+		StartHeightFieldResolution = FIntPoint::ZeroValue;
+		return;
+	}
+
+	// Samples off the landscape use the lowest terrain height, which never raises the start of the blend.
+	for (int32 Index = 0; Index < Heights.Num(); Index++)
+	{
+		if (!Sampled[Index])
+		{
+			Heights[Index] = static_cast<float>(MinHeight);
+		}
+	}
+
+	StartHeightField = MoveTemp(Heights);
+	StartHeightFieldResolution = Resolution;
+	StartHeightFieldOrigin = Bounds.Min;
+	StartHeightFieldSpacing = Spacing;
+	StartHeightFieldMin = MinHeight;
+
+	UE_LOG(LogTemp, Log, TEXT("Baked a %dx%d start heightfield for '%s'."), Resolution.X, Resolution.Y, *GetName())
+	OnGeometryChanged.Broadcast(this);
+}
 #endif
+
+void AVerticalBlendArea::EvaluateBatch(TArrayView<const AVerticalBlendArea* const> InAreas, const FVector& Point, TArrayView<float> OutWeights)
+{
+	check(InAreas.Num() == OutWeights.Num());
+
+	for (int32 Index = 0; Index < InAreas.Num(); Index++)
+	{
+		OutWeights[Index] = InAreas[Index] != nullptr ? InAreas[Index]->AVerticalBlendArea::GetBlendWeight(Point) : 0.f;
+	}
+}
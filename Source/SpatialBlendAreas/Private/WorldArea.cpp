@@ -10,15 +10,16 @@ subjected to the respective product licensing terms.
 
 #include "WorldArea.h"
 #include "Components/SplineComponent.h"
+#include "Components/LineBatchComponent.h"
+#include "BlendAreaDebugSubsystem.h"
+
+FOnWorldAreaGeometryChanged AWorldArea::OnGeometryChanged;
 
 AWorldArea::AWorldArea()
 {
+	// Debug visualization is drawn centrally by UBlendAreaDebugSubsystem, so areas never need to tick.
 	PrimaryActorTick.bCanEverTick = false;
 
-#if WITH_EDITOR
-	PrimaryActorTick.bCanEverTick = true;
-#endif
-
 	InitializeSplineComponent();
 	SetRootComponent(SplineComponent);
 	SetCanBeDamaged(false);
@@ -31,8 +32,8 @@ void AWorldArea::InitializeSplineComponent()
 	// A closed spline loop defines the polygon area.
 	SplineComponent->SetClosedLoop(true);
 
-	// Interpolation mode should always be 'Linear' for the containment algorithm to work correctly.
-	// Do not change this setting for any of the spline input keys from the editor properties.
+	// Default to 'Linear' interpolation, which maps each spline point to exactly one polygon vertex.
+	// Curved points are supported too, and get tessellated into line segments when the area initializes.
 	for (auto& Point : SplineComponent->SplineCurves.Position.Points)
 	{
 		Point.InterpMode = EInterpCurveMode::CIM_Linear;
@@ -54,11 +55,44 @@ void AWorldArea::InitializeSplineComponent()
 void AWorldArea::BeginPlay()
 {
 	Super::BeginPlay();
-	InitializeArea();
+
+	if (!bIsInitializedForPlay)
+	{
+		InitializeArea();
+	}
+
+#if WITH_EDITOR
+	if (UBlendAreaDebugSubsystem* DebugSubsystem = UWorld::GetSubsystem<UBlendAreaDebugSubsystem>(GetWorld()))
+	{
+		DebugSubsystem->RegisterArea(this);
+	}
+#endif
+}
+
+void AWorldArea::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	Super::EndPlay(EndPlayReason);
+	bIsInitializedForPlay = false;
+
+#if WITH_EDITOR
+	if (UBlendAreaDebugSubsystem* DebugSubsystem = UWorld::GetSubsystem<UBlendAreaDebugSubsystem>(GetWorld()))
+	{
+		DebugSubsystem->UnregisterArea(this);
+	}
+#endif
 }
 
 void AWorldArea::InitializeArea()
 {
+	// For some reason, the editor automatically adds three FVector2D elements to a TArray tagged with a UPROPERTY(),
+	// so first empty the container before retrieving the spline points. Keep the allocation for repeated rebuilds.
+	// Emptied before validating the splines too, so that an area edited into an invalid shape reads as empty
+	// instead of keeping its previous geometry.
+	Points.Reset();
+	RingOffsets.Reset();
+	Edges.Reset();
+	Bounds = FBox2D(ForceInit);
+
 	if (!IsValid(SplineComponent))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("WorldArea is missing its SplineComponent."))
@@ -73,26 +107,123 @@ void AWorldArea::InitializeArea()
 		return;
 	}
 
-	// For some reason, the editor automatically adds three FVector2D elements to a TArray tagged with a UPROPERTY(),
-	// so first empty the container before retrieving the spline points.
-	Points.Empty();
+	// The root spline is the outer boundary, any additional spline components of the actor define holes.
+	RingOffsets.Add(0);
+	TessellateSpline(SplineComponent, Points);
+	RingOffsets.Add(Points.Num());
+
+	TInlineComponentArray<USplineComponent*> SplineComponents;
+	GetComponents(SplineComponents);
+
+	for (const USplineComponent* HoleSpline : SplineComponents)
+	{
+		if (HoleSpline == SplineComponent)
+		{
+			continue;
+		}
+
+		if (HoleSpline->GetNumberOfSplinePoints() < 3)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Ignoring hole spline '%s' of WorldArea '%s' with less than three points."),
+				   *HoleSpline->GetName(), *GetName())
+			continue;
+		}
+
+		TessellateSpline(HoleSpline, Points);
+		RingOffsets.Add(Points.Num());
+	}
+
+	// Gather the edges of all rings into one shared buffer, so that every query is a single pass over it.
+	Edges.Reserve(Points.Num());
+
+	for (int32 Ring = 0; Ring < RingOffsets.Num() - 1; Ring++)
+	{
+		const int32 RingStart = RingOffsets[Ring];
+		const int32 RingEnd = RingOffsets[Ring + 1];
+
+		for (int32 Index = RingStart; Index < RingEnd; Index++)
+		{
+			Edges.Add({ Points[Index], Points[Index == RingEnd - 1 ? RingStart : Index + 1] });
+		}
+	}
+
+	// The holes are inside the outer boundary, so its vertices alone define the bounds.
+	Bounds = FBox2D(Points.GetData(), RingOffsets[1]);
+}
+
+void AWorldArea::InitializeAreaForPlay()
+{
+	InitializeArea();
+	bIsInitializedForPlay = true;
+}
+
+void AWorldArea::TessellateSpline(const USplineComponent* Spline, TArray<FVector2D>& OutPoints) const
+{
+	// Store the world positions as 2D vectors, since the containment tests are done on an XY-plane.
+	auto SampleSpline = [Spline](const float InputKey)
+	{
+		return FVector2D(Spline->GetLocationAtSplineInputKey(InputKey, ESplineCoordinateSpace::World));
+	};
+
+	const double Tolerance = FMath::Max(CurveTessellationTolerance, 1.0);
+	const int32 PointCount = Spline->GetNumberOfSplinePoints();
+
+	// An open spline is closed with a straight edge back to its first point.
+	const int32 CurvedSegmentCount = Spline->IsClosedLoop() ? PointCount : PointCount - 1;
+
+	// Recursively halves a curved segment until it deviates less than the tolerance from its chord, so flat stretches
+	// get few vertices and tight curves many. Quarter points are checked as well, since the midpoint of an S-shaped
+	// segment may lie exactly on the chord. Appends the vertices strictly between the segment end points.
+	TFunction<void(float, float, const FVector2D&, const FVector2D&, int32)> Subdivide;
+	Subdivide = [&](const float StartKey, const float EndKey, const FVector2D& Start, const FVector2D& End, const int32 Depth)
+	{
+		const float MidKey = (StartKey + EndKey) * 0.5f;
+		const FVector2D Mid = SampleSpline(MidKey);
+
+		if (Depth < MaxTessellationDepth)
+		{
+			const FVector2D QuarterA = SampleSpline((StartKey + MidKey) * 0.5f);
+			const FVector2D QuarterB = SampleSpline((MidKey + EndKey) * 0.5f);
+			const double ErrorSquared = FMath::Max3(FVector2D::DistSquared(Mid, FMath::ClosestPointOnSegment2D(Mid, Start, End)),
+													 FVector2D::DistSquared(QuarterA, FMath::ClosestPointOnSegment2D(QuarterA, Start, End)),
+													 FVector2D::DistSquared(QuarterB, FMath::ClosestPointOnSegment2D(QuarterB, Start, End)));
+
+			if (ErrorSquared <= FMath::Square(Tolerance))
+			{
+				return;
+			}
+
+			Subdivide(StartKey, MidKey, Start, Mid, Depth + 1);
+			OutPoints.Add(Mid);
+			Subdivide(MidKey, EndKey, Mid, End, Depth + 1);
+		}
+	};
 
-	// Store the world positions of spline input keys as 2D vectors, since the containment tests are done on an XY-plane.
 	for (int32 Index = 0; Index < PointCount; Index++)
 	{
-		const FVector Position3D = SplineComponent->GetLocationAtSplineInputKey(Index, ESplineCoordinateSpace::World);
-		const FVector2D Position2D = FVector2D(Position3D);
-		Points.Emplace(Position2D);
+		const FVector2D Start = SampleSpline(Index);
+		OutPoints.Add(Start);
+
+		// The interpolation mode of a segment is determined by the point it starts from.
+		if (Index < CurvedSegmentCount && Spline->GetSplinePointType(Index) != ESplinePointType::Linear)
+		{
+			// The last segment of a closed loop ends at input key 'PointCount', which maps back to the first point.
+			Subdivide(Index, Index + 1, Start, SampleSpline(Index + 1), 0);
+		}
 	}
 }
 
 void AWorldArea::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+}
 
-#if WITH_EDITOR
-	DebugDraw();
-#endif
+void AWorldArea::ForEachEdge(TFunctionRef<void(const FVector2D&, const FVector2D&)> Visitor) const
+{
+	for (const FEdge& Edge : Edges)
+	{
+		Visitor(Edge.Start, Edge.End);
+	}
 }
 
 bool AWorldArea::IsInside(const FVector2D& Point) const
@@ -107,23 +238,28 @@ bool AWorldArea::IsInside(const FVector& Point) const
 
 bool AWorldArea::IsInsideWorldArea(const FVector2D& Point) const
 {
-	if (Points.Num() < 3)
+	return IsInsideEdges(Edges, Point);
+}
+
+bool AWorldArea::IsInsideEdges(TArrayView<const FEdge> InEdges, const FVector2D& Point) const
+{
+	if (InEdges.Num() < 3)
 	{
 		return false;
 	}
 
 	// Solve the point-in-polygon problem with the even-odd rule algorithm: https://en.wikipedia.org/wiki/Point_in_polygon
 	// If a ray shot from the point to the infinity (in a practical sense) crosses an odd number of polygon line segments,
-	// the point resides inside the polygon.
+	// the point resides inside the polygon. Since the edges of the holes are included, points inside a hole are outside.
 
 	const FVector2D& A1 = Point;
 	const FVector2D A2 = FVector2D(A1.X, RayLength);
 	uint32 IntersectCount = 0;
 
-	for (int32 Index = 0; Index < Points.Num(); Index++)
+	for (const FEdge& Edge : InEdges)
 	{
-		const FVector2D& B1 = Points[Index];
-		const FVector2D& B2 = Points[Index == Points.Num() - 1 ? 0 : Index + 1];
+		const FVector2D& B1 = Edge.Start;
+		const FVector2D& B2 = Edge.End;
 
 		// Line intersection algorithm: https://www.dcs.gla.ac.uk/~pat/52233/slides/Geometry1x1.pdf
 
@@ -239,10 +375,11 @@ bool AWorldArea::GetClosestPointAndDistanceSquared(const FVector2D& Point, FVect
 
 	bool FirstEntryHandled = false;
 
-	for (int32 Index = 0; Index < Points.Num(); Index++)
+	// The nearest boundary may be on the outer ring or on any of the holes.
+	for (const FEdge& Edge : Edges)
 	{
-		const FVector2D& LineStart = Points[Index];
-		const FVector2D& LineEnd = Points[Index == Points.Num() - 1 ? 0 : Index + 1];
+		const FVector2D& LineStart = Edge.Start;
+		const FVector2D& LineEnd = Edge.End;
 
 		FVector2D ClosestPointOnSegment = FMath::ClosestPointOnSegment2D(Point, LineStart, LineEnd);
 		double DistanceSquared = FVector2D::DistSquared(Point, ClosestPointOnSegment);
@@ -258,22 +395,139 @@ bool AWorldArea::GetClosestPointAndDistanceSquared(const FVector2D& Point, FVect
 	return true;
 }
 
-#if WITH_EDITOR
+bool AWorldArea::GetClosestPointAndDistanceSquared(const FVector2D& Point, const double MaxDistanceSquared, FVector2D& OutClosestPoint, double& OutDistanceSquared) const
+{
+	double BestDistanceSquared = MaxDistanceSquared;
+	bool bFound = false;
 
-void AWorldArea::DebugDraw() const
+	for (const FEdge& Edge : Edges)
+	{
+		// The distance to the bounding box of an edge is a lower bound for the distance to the edge itself.
+		const double BoxDistanceX = FMath::Max3(FMath::Min(Edge.Start.X, Edge.End.X) - Point.X, Point.X - FMath::Max(Edge.Start.X, Edge.End.X), 0.0);
+		const double BoxDistanceY = FMath::Max3(FMath::Min(Edge.Start.Y, Edge.End.Y) - Point.Y, Point.Y - FMath::Max(Edge.Start.Y, Edge.End.Y), 0.0);
+
+		if (BoxDistanceX * BoxDistanceX + BoxDistanceY * BoxDistanceY > BestDistanceSquared)
+		{
+			continue;
+		}
+
+		const FVector2D ClosestPointOnSegment = FMath::ClosestPointOnSegment2D(Point, Edge.Start, Edge.End);
+		const double DistanceSquared = FVector2D::DistSquared(Point, ClosestPointOnSegment);
+
+		if (DistanceSquared <= BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			OutClosestPoint = ClosestPointOnSegment;
+			bFound = true;
+		}
+	}
+
+	if (bFound)
+	{
+		OutDistanceSquared = BestDistanceSquared;
+	}
+
+	return bFound;
+}
+
+bool AWorldArea::GetSignedDistance(const FVector2D& Point, FWorldAreaSignedDistance& OutResult, const double MaxDistanceSquared) const
 {
-	if (bEditorDebugDrawArea && Points.Num() >= 3)
+	OutResult = FWorldAreaSignedDistance();
+
+	if (Edges.Num() < 3)
 	{
-		for (int32 Index = 0; Index < Points.Num(); Index++)
+		return false;
+	}
+
+	const FVector2D RayEnd = FVector2D(Point.X, RayLength);
+	double BestDistanceSquared = MaxDistanceSquared;
+	uint32 IntersectCount = 0;
+	bool bIsResolved = false;
+	bool bResolvedInside = false;
+
+	for (const FEdge& Edge : Edges)
+	{
+		const double MinX = FMath::Min(Edge.Start.X, Edge.End.X);
+		const double MaxX = FMath::Max(Edge.Start.X, Edge.End.X);
+		const double MinY = FMath::Min(Edge.Start.Y, Edge.End.Y);
+		const double MaxY = FMath::Max(Edge.Start.Y, Edge.End.Y);
+
+		// The containment ray runs from the point towards +Y, so only edges spanning its X and reaching
+		// the height of the point can touch it. The crossing rules are the same as in IsInsideEdges().
+		if (!bIsResolved && MinX <= Point.X && MaxX >= Point.X && MaxY >= Point.Y && AreIntersecting(Point, RayEnd, Edge.Start, Edge.End))
+		{
+			if (GetOrientation(Edge.Start, Point, Edge.End) == EOrientation::Colinear)
+			{
+				bResolvedInside = IsPointOnLine(RayEnd, Edge.End, Point);
+				bIsResolved = true;
+			}
+			else
+			{
+				IntersectCount++;
+			}
+		}
+
+		// The distance to the bounding box of an edge is a lower bound for the distance to the edge itself.
+		const double BoxDistanceX = FMath::Max3(MinX - Point.X, Point.X - MaxX, 0.0);
+		const double BoxDistanceY = FMath::Max3(MinY - Point.Y, Point.Y - MaxY, 0.0);
+
+		if (BoxDistanceX * BoxDistanceX + BoxDistanceY * BoxDistanceY > BestDistanceSquared)
 		{
-			const FVector2D& PointA = Points[Index];
-			const FVector2D& PointB = Points[Index == Points.Num() - 1 ? 0 : Index + 1];
+			continue;
+		}
+
+		const FVector2D ClosestPointOnSegment = FMath::ClosestPointOnSegment2D(Point, Edge.Start, Edge.End);
+		const double DistanceSquared = FVector2D::DistSquared(Point, ClosestPointOnSegment);
+
+		if (DistanceSquared <= BestDistanceSquared)
+		{
+			BestDistanceSquared = DistanceSquared;
+			OutResult.ClosestPoint = ClosestPointOnSegment;
+			OutResult.bHasClosestPoint = true;
+		}
+	}
+
+	OutResult.bIsInside = bIsResolved ? bResolvedInside : IntersectCount % 2 == 1;
+	OutResult.DistanceSquared = BestDistanceSquared;
+	OutResult.SignedDistance = OutResult.bIsInside ? -FMath::Sqrt(BestDistanceSquared) : FMath::Sqrt(BestDistanceSquared);
+	return true;
+}
+
+#if WITH_EDITOR
 
-			const FVector LineStart = FVector(PointA.X, PointA.Y, EditorDrawHeight);
-			const FVector LineEnd = FVector(PointB.X, PointB.Y, EditorDrawHeight);
+void AWorldArea::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+	RebuildArea();
+}
+
+void AWorldArea::RebuildArea()
+{
+	if (HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+	{
+		return;
+	}
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	InitializeArea();
+	OnGeometryChanged.Broadcast(this);
+
+	UE_LOG(LogTemp, Verbose, TEXT("Rebuilt WorldArea '%s' (%d vertices) in %.3f ms."), *GetName(), Points.Num(),
+		   FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles))
+}
+
+void AWorldArea::AppendDebugLines(TArray<FBatchedLine>& OutLines, TArray<FBatchedPoint>& OutPoints) const
+{
+	if (bEditorDebugDrawArea && Edges.Num() >= 3)
+	{
+		for (const FEdge& Edge : Edges)
+		{
+			const FVector LineStart = FVector(Edge.Start.X, Edge.Start.Y, EditorDrawHeight);
+			const FVector LineEnd = FVector(Edge.End.X, Edge.End.Y, EditorDrawHeight);
 
-			DrawDebugLine(this->GetWorld(), LineStart, LineEnd, EditorDrawColor);
-			DrawDebugPoint(this->GetWorld(), LineStart, 10.f, EditorDrawColor);
+			OutLines.Emplace(LineStart, LineEnd, EditorDrawColor, 0.f, 0.f, SDPG_World);
+			OutPoints.Emplace(LineStart, EditorDrawColor, 10.f, 0.f, SDPG_World);
 		}
 	}
 }
@@ -12,6 +12,7 @@ subjected to the respective product licensing terms.
 
 #include "CoreMinimal.h"
 #include "WorldArea.h"
+#include "BlendFalloffTable.h"
 #include "GameFramework/Actor.h"
 #include "BlendArea.generated.h"
 
@@ -30,6 +31,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/** 
 	* The distance from a zero point at which the blend weight is 1 when the measurement point is inside the the blend area.
@@ -39,15 +41,45 @@ protected:
 	UPROPERTY(EditAnywhere)
 	double BlendDistance;
 
+	/** 
+	* Optional curve for shaping the blend. Maps the normalized distance from the zero point (0 at the zero point,
+	* 1 at 'BlendDistance') to a blend weight between 0 and 1. The curve is baked into a small lookup table
+	* when the area initializes, so editing it during play has no effect. Areas sharing a curve share the table.
+	*/
+	UPROPERTY(EditAnywhere)
+	class UCurveFloat* FalloffCurve = nullptr;
+
+	/** The baked FalloffCurve, or null when the default falloff of the area type is used. */
+	TSharedPtr<const FBlendFalloffTable, ESPMode::ThreadSafe> FalloffTable;
+
+	/** The quantity the derived area type evaluates FalloffTable with. */
+	virtual EBlendFalloffDomain GetFalloffDomain() const { return EBlendFalloffDomain::Linear; }
+
 public:	
 
 	/** 
 	* The relative priority of this blend area. Used when calculating the blend weight distribution between multiple areas. 
-	* The larger the value, the higher the priority. 
+	* The larger the value, the higher the priority. Use SetPriority() to change it during play.
 	*/
 	UPROPERTY(EditAnywhere)
 	uint32 Priority;
 
+	/** Changes the priority and re-sorts the area in the arrangement grid of UBlendAreaSubsystem. */
+	void SetPriority(const uint32 InPriority);
+
 	virtual void Tick(float DeltaTime) override;
+	virtual void InitializeArea() override;
 	virtual float GetBlendWeight(const FVector& Point) const PURE_VIRTUAL(ABlendArea::GetBlendWeight, return 0.0;);
+
+	/** 
+	* Returns the blend weight of a point already known to be inside the area on the XY-plane, e.g. through
+	* the arrangement grid of UBlendAreaSubsystem. Skips the containment test where the area type allows it.
+	*/
+	virtual float GetBlendWeightContained(const FVector& Point) const { return GetBlendWeight(Point); }
+
+	/** 
+	* Evaluates the blend weights of a batch of areas, writing zero for null entries. The built-in area types hide
+	* this with a statically bound version; this one dispatches virtually and serves any other subclass.
+	*/
+	static void EvaluateBatch(TArrayView<const ABlendArea* const> Areas, const FVector& Point, TArrayView<float> OutWeights);
 };
@@ -0,0 +1,54 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BlendAreaDebugSubsystem.generated.h"
+
+class AWorldArea;
+
+/**
+* Draws the debug visualization of all world areas in editor builds. Area outlines are kept in a single persistent
+* line batch that is only rebuilt when an area is added, removed or its geometry changes, so areas do not need
+* to tick. Only areas with per-frame visualization (e.g. a horizontal blend test actor) are visited every frame.
+*/
+UCLASS()
+class SPATIALBLENDAREAS_API UBlendAreaDebugSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterArea(AWorldArea* Area);
+	void UnregisterArea(AWorldArea* Area);
+
+	/** Requests the batched outlines to be rebuilt on the next tick. */
+	void MarkDirty() { bIsDirty = true; }
+
+private:
+
+	void OnAreaGeometryChanged(AWorldArea* Area);
+	void RebuildLineBatch();
+
+	UPROPERTY()
+	class ULineBatchComponent* LineBatcher = nullptr;
+
+	TArray<TWeakObjectPtr<AWorldArea>> Areas;
+	FDelegateHandle GeometryChangedHandle;
+	bool bIsDirty = false;
+};
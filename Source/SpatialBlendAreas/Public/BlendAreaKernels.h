@@ -0,0 +1,101 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BlendArea.h"
+#include "HorizontalBlendArea.h"
+#include "VerticalBlendArea.h"
+
+/** The blend area types that are evaluated through their own, statically bound kernel. */
+enum class EBlendAreaKind : uint8
+{
+	Horizontal,
+	Vertical,
+
+	/** Any other native subclass of ABlendArea, evaluated through the virtual interface. */
+	Custom
+};
+
+/**
+* The evaluation policy of a blend area type. The default binds the calls of the given type statically, so that
+* evaluating a batch of areas of one type needs no virtual dispatch.
+*/
+template<typename AreaType>
+struct TBlendAreaKernel
+{
+	static float GetBlendWeight(const ABlendArea& Area, const FVector& Point)
+	{
+		return static_cast<const AreaType&>(Area).AreaType::GetBlendWeight(Point);
+	}
+
+	static float GetBlendWeightContained(const ABlendArea& Area, const FVector& Point)
+	{
+		return static_cast<const AreaType&>(Area).AreaType::GetBlendWeightContained(Point);
+	}
+
+	static void EvaluateBatch(TArrayView<const AreaType* const> Areas, const FVector& Point, TArrayView<float> OutWeights)
+	{
+		AreaType::EvaluateBatch(Areas, Point, OutWeights);
+	}
+};
+
+/**
+* The extension point for custom C++ subclasses: areas of any other type keep going through the virtual
+* GetBlendWeight() and GetBlendWeightContained() of ABlendArea.
+*/
+template<>
+struct TBlendAreaKernel<ABlendArea>
+{
+	static float GetBlendWeight(const ABlendArea& Area, const FVector& Point) { return Area.GetBlendWeight(Point); }
+	static float GetBlendWeightContained(const ABlendArea& Area, const FVector& Point) { return Area.GetBlendWeightContained(Point); }
+
+	static void EvaluateBatch(TArrayView<const ABlendArea* const> Areas, const FVector& Point, TArrayView<float> OutWeights)
+	{
+		ABlendArea::EvaluateBatch(Areas, Point, OutWeights);
+	}
+};
+
+namespace BlendAreaKernels
+{
+	/**
+	* Returns the kernel an area is evaluated with. Blueprint subclasses use the kernel of their native parent,
+	* since they cannot override the evaluation, whereas native subclasses of the built-in types are Custom.
+	*/
+	SPATIALBLENDAREAS_API EBlendAreaKind GetKind(const ABlendArea* Area);
+
+	inline float GetBlendWeight(const EBlendAreaKind Kind, const ABlendArea& Area, const FVector& Point)
+	{
+		switch (Kind)
+		{
+		case EBlendAreaKind::Horizontal:
+			return TBlendAreaKernel<AHorizontalBlendArea>::GetBlendWeight(Area, Point);
+		case EBlendAreaKind::Vertical:
+			return TBlendAreaKernel<AVerticalBlendArea>::GetBlendWeight(Area, Point);
+		default:
+			return TBlendAreaKernel<ABlendArea>::GetBlendWeight(Area, Point);
+		}
+	}
+
+	inline float GetBlendWeightContained(const EBlendAreaKind Kind, const ABlendArea& Area, const FVector& Point)
+	{
+		switch (Kind)
+		{
+		case EBlendAreaKind::Horizontal:
+			return TBlendAreaKernel<AHorizontalBlendArea>::GetBlendWeightContained(Area, Point);
+		case EBlendAreaKind::Vertical:
+			return TBlendAreaKernel<AVerticalBlendArea>::GetBlendWeightContained(Area, Point);
+		default:
+			return TBlendAreaKernel<ABlendArea>::GetBlendWeightContained(Area, Point);
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BlendAreaProfileCommandlet.generated.h"
+
+/**
+* Loads a map, reports the complexity of its blend areas (vertex counts, bounds overlap, nesting depth) and
+* measures the cost of IsInside(), GetBlendWeight() and the full weight distribution with random and grid
+* query sweeps. The two-pass containment and boundary distance (IsInside() and GetClosestPointAndDistanceSquared())
+* is measured against the fused GetSignedDistance() as well, and the distribution over all areas against the one
+* through the arrangement grid of UBlendAreaSubsystem. The results are written as a CSV of nanoseconds per query,
+* per area and in total.
+*
+* Usage: -run=BlendAreaProfile -Map=/Game/Maps/MyMap [-Csv=<file>] [-RandomQueries=10000] [-GridSize=100]
+*        [-Seed=0] [-Z=0] [-BudgetNs=<ns>] -nullrhi
+*
+* With -BudgetNs, the commandlet fails if a full distribution costs more than the given time per query.
+*/
+UCLASS()
+class UBlendAreaProfileCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBlendAreaProfileCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
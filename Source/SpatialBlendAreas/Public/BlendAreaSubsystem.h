@@ -0,0 +1,243 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BlendAreaKernels.h"
+#include "BlendAreaSubsystem.generated.h"
+
+class ABlendArea;
+class AWorldArea;
+
+/** An area that may contain the points of an arrangement grid cell. */
+struct FBlendAreaCandidate
+{
+	/** The shared index of the area, see UBlendAreaSubsystem::GetAreaIndex(). */
+	int32 AreaIndex = INDEX_NONE;
+
+	/** The priority of the area when it was indexed. Candidate lists are sorted by it. */
+	uint32 Priority = 0;
+
+	/** True if the whole cell is inside the area, i.e. no containment test is needed. */
+	bool bContainsCell = false;
+};
+
+/** The result of a proximity query against the registered blend areas. */
+struct FBlendAreaDistance
+{
+	const ABlendArea* Area = nullptr;
+
+	/** The distance from the query point to the area boundary on the XY-plane, zero if the area contains the point. */
+	double Distance = 0.0;
+
+	/** The closest point on the area boundary, or the query point itself if the area contains it. */
+	FVector2D ClosestPoint = FVector2D::ZeroVector;
+};
+
+/**
+* Owns the registry of blend areas in a world and evaluates their isolated blend weights on behalf of every
+* UBlendWeightDistributor in it. Each (area, position) pair is evaluated at most once per frame, so managers
+* that share areas and a listener position (e.g. ambience, music and reverb) do not repeat the polygon tests.
+*
+* The registered areas are also indexed in a hierarchical arrangement grid. Each area is placed on the level whose
+* cells are large enough for its bounds to span at most MaxCellsPerAxis cells per axis, so its footprint stays small
+* however large the area is. Every cell lists the areas overlapping it, sorted by descending priority, and flags the
+* ones that contain the whole cell. A query only evaluates the areas of its cells and skips the containment test of
+* the flagged ones. The cells are anchored at the world origin, so registering, unregistering or changing an area
+* only touches the cells of that area.
+*
+* For proximity queries, the bounds of the registered areas are kept in a bounding volume hierarchy that is
+* searched best-first, so only the areas that can still beat the current result have their edges measured.
+* The hierarchy is updated in place as well: a changed area only refits the nodes above its leaf.
+*
+* When the world begins play, the subsystem initializes all areas already in it in one parallel batch and builds
+* its indices right away, instead of leaving each area to initialize itself serially in its own BeginPlay.
+*/
+UCLASS()
+class SPATIALBLENDAREAS_API UBlendAreaSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/**
+	* Adds an area to the registry if needed and returns its shared index, or INDEX_NONE for an invalid area. An area
+	* registered before it was initialized is indexed when it is registered again with bounds.
+	*/
+	int32 RegisterArea(const ABlendArea* BlendArea);
+
+	/** Removes an area from the registry. Its shared index may be handed out to an area registered later. */
+	void UnregisterArea(const ABlendArea* BlendArea);
+
+	/** Re-indexes a registered area after its geometry or priority has changed. */
+	void RefreshArea(const ABlendArea* BlendArea);
+
+	/** Returns the shared index of a registered area, or INDEX_NONE if the area is not registered. */
+	int32 GetAreaIndex(const ABlendArea* BlendArea) const;
+
+	/** Returns the registered areas, indexed by shared index. The entries of unregistered areas are null. */
+	TArrayView<const TWeakObjectPtr<const ABlendArea>> GetAreas() const { return Areas; }
+
+	/** 
+	* Returns the slot of a blend position in the evaluation cache of the current frame.
+	* Call once per update and pass the slot to GetBlendWeight().
+	*/
+	int32 FindOrAddPosition(const FVector& Position);
+
+	/** Returns the isolated blend weight of a registered area, evaluating it only on the first request of the frame. */
+	float GetBlendWeight(const int32 AreaIndex, const int32 PositionSlot);
+
+	/** 
+	* Drops the weights evaluated so far in the current frame, so the following queries evaluate the areas again.
+	* For tools and tests that run many updates within one engine frame, each standing for a frame of its own.
+	*/
+	void InvalidateCache();
+
+	/** 
+	* Returns the areas that can have a non-zero weight at a cached blend position, sorted by descending priority.
+	* The weight of every other registered area is zero at that position.
+	*/
+	TArrayView<const FBlendAreaCandidate> GetCandidates(const int32 PositionSlot) const
+	{
+		return MakeArrayView(CachedCandidates.GetData() + CachedCandidateOffsets[PositionSlot],
+							 CachedCandidateOffsets[PositionSlot + 1] - CachedCandidateOffsets[PositionSlot]);
+	}
+
+	/** Returns the areas that can contain the given point, sorted by descending priority. Valid until the next call. */
+	TArrayView<const FBlendAreaCandidate> FindCandidates(const FVector2D& Point);
+
+	/** 
+	* Finds the registered areas whose boundary is within 'Radius' from the point, or which contain it.
+	* The results are sorted by ascending distance.
+	*/
+	void FindAreasInRadius(const FVector2D& Point, const double Radius, TArray<FBlendAreaDistance>& OutAreas);
+
+	/** Finds up to 'Count' registered areas closest to the point, sorted by ascending distance. */
+	void FindNearestAreas(const FVector2D& Point, const int32 Count, TArray<FBlendAreaDistance>& OutAreas);
+
+private:
+
+	/** An area spans at most this many cells per axis on the grid level it is placed on. */
+	static constexpr int32 MaxCellsPerAxis = 16;
+
+	/** The cell size doubles from one grid level to the next. */
+	static constexpr int32 MaxGridLevels = 24;
+
+	/** The number of slowest areas listed in the log after the bulk initialization. */
+	static constexpr int32 SlowestAreasToLog = 5;
+
+	/** Initializes the given areas in parallel and logs the total time and the slowest areas. */
+	void InitializeAreas(TArrayView<AWorldArea* const> WorldAreas);
+
+	void OnAreaGeometryChanged(AWorldArea* Area);
+	void ResetCache();
+
+	/** Appends the candidates of a point to the array, sorted by descending priority. */
+	void GatherCandidates(const FVector2D& Point, TArray<FBlendAreaCandidate>& OutCandidates) const;
+
+	/** Indexes the current geometry of an area in the cells it overlaps. */
+	void AddToGrid(const int32 AreaIndex);
+	void RemoveFromGrid(const int32 AreaIndex);
+
+	struct FGridCell
+	{
+		TArray<FBlendAreaCandidate, TInlineAllocator<4>> Candidates;
+	};
+
+	struct FGridLevel
+	{
+		TMap<FIntPoint, FGridCell> Cells;
+		int32 AreaCount = 0;
+	};
+
+	/** Level N has cells of GridCellSize * 2^N. */
+	TArray<FGridLevel> GridLevels;
+	double GridCellSize = 0.0;
+
+	/** Scratch for marking the cells the boundary of an area passes through. */
+	TBitArray<> BoundaryCells;
+
+	/** Scratch returned by FindCandidates(). */
+	TArray<FBlendAreaCandidate> CandidateScratch;
+
+	/** The leaves hold up to twice this many areas before they are split. */
+	static constexpr int32 MaxAreasPerLeaf = 4;
+
+	struct FBoundsTreeNode
+	{
+		/** Invalid for leaves whose areas have all been removed. */
+		FBox2D Bounds = FBox2D(ForceInit);
+
+		int32 Parent = INDEX_NONE;
+
+		/** Child node indices for inner nodes, INDEX_NONE for leaves. */
+		int32 Children[2] = { INDEX_NONE, INDEX_NONE };
+
+		/** The shared indices of the areas of a leaf, with room for the one that triggers a split. */
+		TArray<int32, TInlineAllocator<2 * MaxAreasPerLeaf + 1>> Areas;
+	};
+
+	/** Node 0 is the root. */
+	TArray<FBoundsTreeNode> TreeNodes;
+
+	/** Rebuilds a balanced tree from all registered areas. */
+	void BuildTree();
+	int32 BuildTreeNode(TArrayView<int32> NodeAreas, const int32 Parent);
+
+	void AddToTree(const int32 AreaIndex);
+	void RemoveFromTree(const int32 AreaIndex);
+
+	/** Recomputes the bounds of a node and all of its ancestors. */
+	void RefitTree(int32 Node);
+
+	/** Splits an overfull leaf into two leaves at the median of its area centers. */
+	void SplitLeaf(const int32 Node);
+
+	/** Branch-and-bound search for at most 'MaxCount' areas within 'MaxDistance' from the point. */
+	void FindAreas(const FVector2D& Point, const int32 MaxCount, const double MaxDistance, TArray<FBlendAreaDistance>& OutAreas);
+
+	/** Where a registered area is indexed, by shared index. */
+	struct FAreaEntry
+	{
+		int32 GridLevel = INDEX_NONE;
+		FIntPoint MinCell = FIntPoint::ZeroValue;
+		FIntPoint MaxCell = FIntPoint::ZeroValue;
+		int32 TreeLeaf = INDEX_NONE;
+	};
+
+	TArray<TWeakObjectPtr<const ABlendArea>> Areas;
+	TMap<TWeakObjectPtr<const ABlendArea>, int32> AreaIndices;
+	TArray<FAreaEntry> AreaEntries;
+
+	/** The shared indices of unregistered areas, reused by the next registrations. */
+	TArray<int32> FreeAreaIndices;
+
+	/** The kernel each area is evaluated with, indexed by shared index. */
+	TArray<EBlendAreaKind> AreaKinds;
+
+	/** The blend positions queried during CacheFrame. */
+	TArray<FVector, TInlineAllocator<4>> CachedPositions;
+
+	/** The candidates of position slot N are [CachedCandidateOffsets[N], CachedCandidateOffsets[N + 1]) of CachedCandidates. */
+	TArray<FBlendAreaCandidate> CachedCandidates;
+	TArray<int32, TInlineAllocator<5>> CachedCandidateOffsets;
+
+	/** Isolated weights laid out position slot by position slot; a negative value marks a candidate not evaluated yet. */
+	TArray<float> CachedWeights;
+
+	uint64 CacheFrame = 0;
+	FDelegateHandle GeometryChangedHandle;
+};
@@ -0,0 +1,73 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UCurveFloat;
+
+/** The quantity a falloff table is indexed with. */
+enum class EBlendFalloffDomain : uint8
+{
+	/** Indexed with the normalized distance (distance / blend distance). */
+	Linear,
+
+	/** Indexed with the squared normalized distance, which spares the caller a square root. */
+	Squared
+};
+
+/**
+* A falloff curve baked into a small fixed-size lookup table. Tables are shared between all areas using the same
+* curve, curve keys and domain, and they are kept alive only for as long as some area references them.
+*
+* The start of the domain, up to NearRange, is sampled from a finer table of its own. In the squared domain the
+* normalized distance grows with the square root of the index, so a uniform table alone would leave the first
+* 9% of the curve to its first interval, with an interpolation error of up to about 2.2% of the curve's slope.
+* With the finer table, that error stays below about 0.6%, and the square root adds less than 0.1% anywhere else.
+*/
+class SPATIALBLENDAREAS_API FBlendFalloffTable
+{
+public:
+
+	static constexpr int32 Resolution = 128;
+
+	/** The part of the domain covered by NearSamples. Ends on a sample of the main table, so the two meet exactly. */
+	static constexpr float NearRange = 8.f / (Resolution - 1);
+
+	/** 
+	* Returns the shared table for a curve, baking it on the first request or after the keys of the curve
+	* have changed. The curve always maps the normalized distance (0-1) to a weight (0-1), regardless of
+	* the domain the table is indexed with.
+	*/
+	static TSharedRef<const FBlendFalloffTable, ESPMode::ThreadSafe> FindOrBake(const UCurveFloat* Curve, const EBlendFalloffDomain Domain);
+
+	/** Evaluates the baked curve. Alpha is clamped to the 0-1 range of the table's domain. */
+	FORCEINLINE float Evaluate(const float Alpha) const
+	{
+		const float ClampedAlpha = FMath::Clamp(Alpha, 0.f, 1.f);
+		return ClampedAlpha < NearRange ? Sample(NearSamples, ClampedAlpha * (1.f / NearRange)) : Sample(Samples, ClampedAlpha);
+	}
+
+private:
+
+	static FORCEINLINE float Sample(const float (&InSamples)[Resolution], const float Alpha)
+	{
+		const float Position = Alpha * (Resolution - 1);
+		const int32 Index = FMath::Min(static_cast<int32>(Position), Resolution - 2);
+		return FMath::Lerp(InSamples[Index], InSamples[Index + 1], Position - Index);
+	}
+
+	/** The whole domain. */
+	float Samples[Resolution];
+
+	/** The domain up to NearRange. */
+	float NearSamples[Resolution];
+};
@@ -0,0 +1,33 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BlendTraceReplayCommandlet.generated.h"
+
+/**
+* Feeds a recorded blend weight trace through UBlendWeightDistributor using the blend areas of a map,
+* and reports per-frame timing percentiles and the weight differences against the recording.
+*
+* Usage: -run=BlendTraceReplay -Map=/Game/Maps/MyMap -Trace=Path/To/File.bwtrace [-Iterations=1] -nullrhi
+*/
+UCLASS()
+class UBlendTraceReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+
+	UBlendTraceReplayCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
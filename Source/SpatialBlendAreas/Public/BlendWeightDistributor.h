@@ -13,8 +13,33 @@ subjected to the respective product licensing terms.
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "BlendArea.h"
+#include "BlendAreaKernels.h"
+#include "BlendWeightSnapshot.h"
 #include "BlendWeightDistributor.generated.h"
 
+/** Broadcast when the distributed weight of an area becomes non-zero. */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnBlendAreaEntered, const ABlendArea* /*BlendArea*/, float /*Weight*/);
+
+/** Broadcast when the distributed weight of an area drops back to zero. */
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnBlendAreaExited, const ABlendArea* /*BlendArea*/);
+
+/** Broadcast when the distributed weight of an area crosses one of the thresholds set with SetWeightThresholds(). */
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnBlendAreaWeightThresholdCrossed, const ABlendArea* /*BlendArea*/, float /*Threshold*/, float /*Weight*/, bool /*bRising*/);
+
+/** 
+* A read-only view over the weights of the latest distributor update, indexed by area handle. 
+* Nothing is copied; the view stays valid until the distributor is destroyed.
+*/
+struct FBlendWeightView
+{
+	TArrayView<const TWeakObjectPtr<const ABlendArea>> Areas;
+	TArrayView<const float> Weights;
+
+	int32 Num() const { return Weights.Num(); }
+	const ABlendArea* GetArea(const int32 Handle) const { return Areas[Handle].Get(); }
+	float GetWeight(const int32 Handle) const { return Weights[Handle]; }
+};
+
 UCLASS()
 class SPATIALBLENDAREAS_API UBlendWeightDistributor : public UObject
 {
@@ -26,17 +51,107 @@ public:
 
 private:
 
+	/** Registered blend areas. The index of an area in this array is its area handle. */
 	UPROPERTY()
-	TMap<TWeakObjectPtr<const ABlendArea>, float> AreaWeights;
-	
+	TArray<TWeakObjectPtr<const ABlendArea>> Areas;
+
 	UPROPERTY()
-	TArray<TWeakObjectPtr<const ABlendArea>> RelevantAreas;
+	TMap<TWeakObjectPtr<const ABlendArea>, int32> AreaHandles;
+
+	/** Blend weights indexed by area handle. */
+	TArray<float> Weights;
 	
+	/** Handles of the areas with a non-zero isolated weight on the latest update. */
+	TArray<int32> RelevantAreas;
+
+	/** The areas of one type, evaluated together by the kernel of that type. */
+	template<typename AreaType>
+	struct TAreaBatch
+	{
+		TArray<int32> Handles;
+
+		/** Scratch for every evaluation: the areas resolved from their weak pointers and their isolated weights. */
+		TArray<const AreaType*> Areas;
+		TArray<float> Weights;
+	};
+
+	/** The kernel each area is evaluated with, indexed by area handle. */
+	TArray<EBlendAreaKind> AreaKinds;
+
+	TAreaBatch<AHorizontalBlendArea> HorizontalBatch;
+	TAreaBatch<AVerticalBlendArea> VerticalBatch;
+	TAreaBatch<ABlendArea> CustomBatch;
+
+	/** Sizes the scratch of a batch once its handles are known, so that evaluating it never allocates. */
+	template<typename AreaType>
+	void InitializeBatch(TAreaBatch<AreaType>& Batch);
+
+	/** Evaluates the isolated weights of a batch and adds the areas with a non-zero weight to RelevantAreas. */
+	template<typename AreaType>
+	void EvaluateBatch(TAreaBatch<AreaType>& Batch, const FVector& Position);
+
+	TSharedPtr<FBlendWeightSnapshotBuffer, ESPMode::ThreadSafe> SnapshotBuffer;
+
+	/** Optional shared evaluator of isolated area weights, see UBlendAreaSubsystem. */
 	UPROPERTY()
-	TArray<TWeakObjectPtr<const ABlendArea>> SharedPriorityAreas;
+	TWeakObjectPtr<class UBlendAreaSubsystem> SharedEvaluator;
+
+	/** Area handles indexed by shared evaluator index, INDEX_NONE for areas not registered to this distributor. */
+	TArray<int32> SharedAreaHandles;
+
+	/** Shared evaluator indices indexed by area handle, INDEX_NONE for areas the evaluator did not accept. */
+	TArray<int32> SharedAreaIndices;
+
+	/** Returns the handle of a shared evaluator candidate, or INDEX_NONE if the area is not registered to this distributor. */
+	int32 GetSharedHandle(const struct FBlendAreaCandidate& Candidate, const class UBlendAreaSubsystem& Evaluator) const;
+
+	/** Returns the shared evaluator index of an area handle, or INDEX_NONE if the evaluator no longer holds the area at that index. */
+	int32 GetSharedIndex(const int32 Handle, const class UBlendAreaSubsystem& Evaluator) const;
+
+	uint64 FrameNumber = 0;
 	
 	bool bIsInitialized = false;
 
+	/** @param bIsSorted - true if RelevantAreas is already in descending priority order */
+	void DistributeByPriority(const bool bIsSorted);
+
+	/** Handles of the areas with a non-zero distributed weight, as of the latest notified update. */
+	TArray<int32> ActiveAreas;
+	TArray<int32> PreviousActiveAreas;
+
+	/** The distributed weights as of the previous update; only kept up to date for active areas, zero elsewhere. */
+	TArray<float> PreviousWeights;
+
+	/** Sorted ascending. */
+	TArray<float> WeightThresholds;
+
+	/** Zero disables the budgeted mode. */
+	float TimeBudgetMicroseconds = 0.f;
+
+	/** Budgeted mode: the latest isolated weight of each area and the update and position it was evaluated at. */
+	TArray<float> IsolatedWeights;
+	TArray<uint64> EvaluatedFrames;
+	TArray<FVector> EvaluatedPositions;
+
+	/** Budgeted mode: the areas waiting to be re-evaluated on the current update, most outdated first. */
+	TArray<int32> PendingAreas;
+
+	/** Budgeted mode with a shared evaluator: the latest update each area was a candidate at the blend position. */
+	TArray<uint64> CandidateFrames;
+
+	/** Budgeted mode: the position PendingAreas was gathered and sorted for. */
+	FVector PendingPosition = FVector::ZeroVector;
+	bool bHasPendingPosition = false;
+
+	uint64 OldestResultAge = 0;
+
+	void UpdateIsolatedWeightsBudgeted(const FVector& Position);
+
+	/** Gathers and sorts the areas to re-evaluate at a new position, and zeroes the ones that cannot have a weight there. */
+	void GatherPendingAreas(class UBlendAreaSubsystem* Evaluator, const FVector& Position, const uint64 UpdateNumber);
+	void BroadcastStateChanges();
+	void BroadcastThresholdCrossings(const int32 Handle, const float PreviousWeight, const float Weight);
+
 public:
 
 	enum class EResult
@@ -50,15 +165,68 @@ public:
 
 	static void LogResult(UBlendWeightDistributor::EResult Result);
 		
-	/** Register blend areas before starting to update or retrieve weight data.*/
-	EResult Initialize(const TSet<const ABlendArea*>& AreasToRegister);
+	/** 
+	* Register blend areas before starting to update or retrieve weight data.
+	* When a shared evaluator is given, the isolated area weights are requested from it instead of evaluated locally.
+	*/
+	EResult Initialize(const TSet<const ABlendArea*>& AreasToRegister, class UBlendAreaSubsystem* InSharedEvaluator = nullptr);
 
 	/** Call this method before trying to retrieve weight data for some particular area.*/
 	EResult UpdateWeightData(const FVector& Position);
 
+	/** 
+	* Limits the time spent on evaluating areas per update. Areas that are not candidates of the shared evaluator at
+	* the position, or without one, whose bounds do not contain it, get a zero weight right away. The rest are
+	* re-evaluated in order of how far the position has moved since their previous evaluation, until the budget runs
+	* out; the others keep their previous result. While the position stays put, the order of the previous update is
+	* kept. At least one area is evaluated per update. Zero evaluates every area on every update.
+	*/
+	void SetTimeBudget(const float Microseconds);
+
+	/** Budgeted mode: the number of updates since the oldest result in use was evaluated. */
+	uint64 GetOldestResultAge() const { return OldestResultAge; }
+
 	/** Returns weight data for a registered blend area calcuted on the latest update call.*/
 	EResult GetWeight(const ABlendArea*& BlendArea, float& OutWeight);
 
-	/** Returns weight data for all registered blend areas calcuted on the latest update call.*/
+	/** 
+	* Returns weight data for all registered blend areas calcuted on the latest update call.
+	* Copies every weight into the map; prefer GetWeightView() or the delegates below.
+	*/
 	EResult GetAllWeights(TMap<TWeakObjectPtr<const ABlendArea>, float>& OutWeights);
+
+	/** Returns a zero-copy view over the weights calculated on the latest update call. Game thread only. */
+	FBlendWeightView GetWeightView() const { return { Areas, Weights }; }
+
+	/** 
+	* Sets the weights at which OnWeightThresholdCrossed is broadcast. A threshold is crossed when the weight
+	* moves from below it to at or above it (rising) or back (falling).
+	*/
+	void SetWeightThresholds(TArrayView<const float> Thresholds);
+
+	/** 
+	* The delegates below are broadcast from UpdateWeightData() on the game thread, only for areas whose state
+	* changed on that update. Exits are broadcast before entries. Do not update the distributor from a handler.
+	*/
+	FOnBlendAreaEntered OnAreaEntered;
+	FOnBlendAreaExited OnAreaExited;
+	FOnBlendAreaWeightThresholdCrossed OnWeightThresholdCrossed;
+
+	/** Returns the registered blend areas, indexed by area handle. */
+	TArrayView<const TWeakObjectPtr<const ABlendArea>> GetAreas() const { return Areas; }
+
+	/** Returns the weights calculated on the latest update call, indexed by area handle. Game thread only. */
+	TArrayView<const float> GetWeights() const { return Weights; }
+
+	/** Returns the stable handle of a registered blend area, or INDEX_NONE if the area is not registered. */
+	int32 GetAreaHandle(const ABlendArea* BlendArea) const;
+
+	/** 
+	* Returns the buffer that every update is published to as an immutable snapshot indexed by area handle.
+	* Hold on to the returned pointer to read weights from any thread without synchronizing with the game thread.
+	*/
+	TSharedPtr<const FBlendWeightSnapshotBuffer, ESPMode::ThreadSafe> GetSnapshotBuffer() const { return SnapshotBuffer; }
+
+	/** The number of updates published so far. */
+	uint64 GetFrameNumber() const { return FrameNumber; }
 };
@@ -27,6 +27,10 @@ class SPATIALBLENDAREAS_API IBlendWeightInterface
 
 public:
 
+	/** 
+	* The areas whose weights are summed into this consumer. ABlendWeightManager reads the set once, in its
+	* PostInitializeComponents(); changes made to it after that are not picked up.
+	*/
 	const virtual TSet<const ABlendArea*>& GetBlendAreas() const = 0;
 	virtual void SetWeight(const float& Weight) = 0;
 	virtual bool GetWeight(float& OutWeight) const = 0; 
@@ -12,6 +12,7 @@ subjected to the respective product licensing terms.
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "BlendWeightTrace.h"
 #include "BlendWeightManager.generated.h"
 
 UCLASS()
@@ -26,6 +27,7 @@ public:
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	/**
 	* Retrieves the first listener from Unreal Engine's FAudioDevice as the default implementation.
@@ -33,24 +35,114 @@ protected:
 	* or if some other custom blend position is needed.
 	*/
 	virtual void GetBlendPosition(FVector& OutPosition) const;
+
+	/** Evaluates the blend areas at the given position and stores the result as the new target weight of every channel. */
 	void UpdateWeights(const FVector& BlendPosition);
 
+	/** Returns true if the output weights should follow their targets through the smoothing stage. */
+	virtual bool ShouldSmoothWeights() const { return SmoothingTimeConstant > 0.f; }
+
+	/** 
+	* Seconds between evaluations of the blend areas; zero evaluates every tick. Combine a longer interval with 
+	* 'SmoothingTimeConstant' to save on area evaluations without audible steps in the output weights.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Smoothing", meta = (ClampMin = "0"))
+	float EvaluationInterval = 0.f;
+
+	/** 
+	* The time constant in seconds with which the output weights approach their latest targets. After one time
+	* constant, about 63% of a change has been applied, independent of the frame rate. Zero disables smoothing.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Smoothing", meta = (ClampMin = "0"))
+	float SmoothingTimeConstant = 0.f;
+
+	/** 
+	* Limits the time in microseconds spent on evaluating blend areas per update, spreading the work of e.g. a teleport
+	* or a burst of newly streamed areas over several frames. Zero evaluates every area on every update.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Budget", meta = (ClampMin = "0"))
+	float EvaluationBudgetMicroseconds = 0.f;
+
 public:	
 
 	virtual void Tick(float DeltaTime) override;
 	virtual void PostInitializeComponents() override;
 
+	/** 
+	* Returns the weight last handed to a consumer component. The manager is the source of truth for output weights,
+	* so there is no need to read them back from the consumers.
+	*
+	* @param Consumer - A component implementing IBlendWeightInterface or IBlendWeightSink
+	* @param Channel - The output channel of a sink, always 0 for IBlendWeightInterface consumers
+	* @return false if the object is not a consumer of this manager or the channel is out of range
+	*/
+	bool GetOutputWeight(const UObject* Consumer, float& OutWeight, const int32 Channel = 0) const;
+
+	/** The distributor of this manager, for observing area weights through its delegates or weight view. */
+	class UBlendWeightDistributor* GetDistributor() const { return BlendWeightDistributor; }
+
 private:
 
 	UPROPERTY()
 	class UBlendWeightDistributor* BlendWeightDistributor;
 
-	UPROPERTY()
-	TArray<TScriptInterface<class IBlendWeightInterface>> ScriptInterfaces;
+	/** 
+	* Routes a slice of the output weights to a consumer. IBlendWeightInterface consumers are adapted 
+	* as single-channel sinks and receive their weight through SetWeight().
+	*/
+	struct FWeightSinkBinding
+	{
+		TWeakObjectPtr<UObject> Object;
+		class IBlendWeightSink* Sink = nullptr;
+		class IBlendWeightInterface* Interface = nullptr;
+		int32 FirstChannel = 0;
+		int32 ChannelCount = 0;
+	};
+
+	TArray<FWeightSinkBinding> SinkBindings;
+
+	/** The index of the binding of each consumer, for GetOutputWeight(). */
+	TMap<const UObject*, int32> SinkBindingIndices;
+
+	/** Distributor area handles summed into each output channel; channel N uses the range [Offsets[N], Offsets[N + 1]). */
+	TArray<int32> ChannelAreaHandles;
+	TArray<int32> ChannelAreaOffsets;
+
+	/** The latest distributed weight of every channel, which the output weights follow. */
+	TArray<float> TargetWeights;
+
+	/** The latest output weight of every channel. */
+	TArray<float> OutputWeights;
+
+	float EvaluationTimer = 0.f;
+	bool bHasEvaluated = false;
+
+	/** True while the output weights differ from the target weights, i.e. they need to be dispatched every tick. */
+	bool bIsSmoothing = false;
+
+	void AddChannel(const TSet<const ABlendArea*>& ChannelAreas);
+	void SmoothWeights(const float DeltaTime);
+	void CopyTargetWeights();
+	void DispatchWeights();
 
 	UPROPERTY()
 	class USceneComponent* RootSceneComponent;
 
+	/** 
+	* Records the blend position and the resulting area weights of every frame into a binary trace that can be
+	* replayed offline with the BlendTraceReplay commandlet. Not available in shipping builds.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Trace")
+	bool bRecordListenerTrace = false;
+
+	/** Trace file path. Relative paths are resolved against the project's Saved/BlendTraces directory. */
+	UPROPERTY(EditAnywhere, Category = "Trace", meta = (EditCondition = "bRecordListenerTrace"))
+	FString TraceFilePath;
+
+	FBlendWeightTraceWriter TraceWriter;
+
+	void StartTraceRecording();
+
 #if WITH_EDITORONLY_DATA
 
 	UPROPERTY(EditAnywhere)
@@ -65,5 +157,8 @@ private:
 
 	void DebugWeights();
 
+	/** Reused for every on-screen debug line, so that drawing the weights does not allocate each frame. */
+	FString DebugMessage;
+
 #endif
 };
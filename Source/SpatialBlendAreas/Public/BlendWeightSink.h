@@ -0,0 +1,43 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "BlendArea.h"
+#include "BlendWeightSink.generated.h"
+
+UINTERFACE(MinimalAPI)
+class UBlendWeightSink : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+* A batched alternative to IBlendWeightInterface for components that consume many weights. A sink declares
+* a number of output channels up front, each being the clamped sum of the weights of its blend areas,
+* and the manager hands it the weights of all of its channels in a single call per update.
+*/
+class SPATIALBLENDAREAS_API IBlendWeightSink
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The number of output channels. Queried once when the owning manager initializes. */
+	virtual int32 GetChannelCount() const = 0;
+
+	/** The blend areas summed into the given channel. Queried once when the owning manager initializes. */
+	const virtual TSet<const ABlendArea*>& GetChannelBlendAreas(const int32 Channel) const = 0;
+
+	/** Receives the output weights of all channels, in channel order. The view is only valid during the call. */
+	virtual void SetWeights(TArrayView<const float> Weights) = 0;
+};
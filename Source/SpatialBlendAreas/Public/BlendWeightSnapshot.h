@@ -0,0 +1,74 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/**
+* A consistent copy of the weights produced by a single UBlendWeightDistributor update.
+*/
+struct SPATIALBLENDAREAS_API FBlendWeightSnapshot
+{
+	/** Incremented on every published update. Zero means that nothing has been published yet. */
+	uint64 FrameNumber = 0;
+
+	/** Blend area weights indexed by the area handles handed out by UBlendWeightDistributor::GetAreaHandle(). */
+	TArray<float> Weights;
+};
+
+/**
+* Publishes blend weight snapshots from the game thread to readers on any thread without locks.
+*
+* The writer rotates between three fixed-size slots, so it never overwrites the most recently published one.
+* Each slot carries a sequence counter that is odd while the slot is being written; readers validate their
+* copy against it and simply retry in the rare case that the writer lapped them during the copy.
+*/
+class SPATIALBLENDAREAS_API FBlendWeightSnapshotBuffer
+{
+public:
+
+	explicit FBlendWeightSnapshotBuffer(const int32 InAreaCount);
+
+	/** Game thread only. The weight count must match the area count given on construction. */
+	void Publish(const uint64 FrameNumber, TArrayView<const float> Weights);
+
+	/**
+	* Copies the latest published snapshot. Safe to call from any thread.
+	*
+	* @return false if nothing has been published yet
+	*/
+	bool Read(FBlendWeightSnapshot& OutSnapshot) const;
+
+	/**
+	* Reads the weight of a single area from the latest published snapshot. Safe to call from any thread.
+	*
+	* @return false if the handle is out of range or nothing has been published yet
+	*/
+	bool ReadWeight(const int32 AreaHandle, float& OutWeight, uint64* OutFrameNumber = nullptr) const;
+
+	int32 GetAreaCount() const { return AreaCount; }
+
+private:
+
+	static constexpr int32 SlotCount = 3;
+
+	struct FSlot
+	{
+		std::atomic<uint32> Sequence{ 0 };
+		uint64 FrameNumber = 0;
+		TArray<float> Weights;
+	};
+
+	FSlot Slots[SlotCount];
+	std::atomic<int32> LatestSlot{ INDEX_NONE };
+	const int32 AreaCount;
+};
@@ -0,0 +1,113 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class AHorizontalBlendArea;
+
+/** Shared by the automation tests of this plugin's modules. */
+namespace BlendWeightTests
+{
+	/** Forwards to the installed allocator and counts the allocations made on the game thread. */
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+
+		explicit FCountingMalloc(FMalloc* InInnerMalloc)
+			: InnerMalloc(InInnerMalloc)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			InnerMalloc->Free(Original);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return InnerMalloc->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+		{
+			return InnerMalloc->QuantizeSize(Count, Alignment);
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("BlendWeightTests");
+		}
+
+		int32 GetAllocationCount() const { return AllocationCount; }
+
+	private:
+
+		/** Worker threads keep allocating while the allocator is installed; only the measured thread counts. */
+		void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				AllocationCount++;
+			}
+		}
+
+		FMalloc* InnerMalloc;
+		int32 AllocationCount = 0;
+	};
+
+	/** Runs the given function with FCountingMalloc installed and returns the game thread allocations it made. */
+	template<typename FunctionType>
+	int32 CountAllocations(FunctionType&& Function)
+	{
+		FMalloc* const OriginalMalloc = GMalloc;
+		FCountingMalloc CountingMalloc(OriginalMalloc);
+		GMalloc = &CountingMalloc;
+
+		Function();
+
+		GMalloc = OriginalMalloc;
+		return CountingMalloc.GetAllocationCount();
+	}
+
+	/** Spawns a square horizontal area. It is left to the world to initialize, as placed areas are. */
+	SPATIALBLENDAREAS_API AHorizontalBlendArea* SpawnArea(UWorld* World, const FVector2D& Center, const double HalfSize, const uint32 Priority);
+
+	/** Initializes the actors of a world and begins play in the order a loaded map goes through. */
+	SPATIALBLENDAREAS_API void BeginPlay(UWorld* World);
+
+	/** Ends play for the actors of a world and destroys it. */
+	SPATIALBLENDAREAS_API void DestroyWorld(UWorld* World);
+
+	/** Sets a property that is only meant to be edited on an instance, such as a debug flag. */
+	SPATIALBLENDAREAS_API void SetBoolProperty(UObject* Object, const FName PropertyName, const bool bValue);
+	SPATIALBLENDAREAS_API void SetObjectProperty(UObject* Object, const FName PropertyName, UObject* Value);
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* A recorded sequence of blend positions and the resulting area weights.
+*
+* File layout: a header (magic, version, area count, area names) followed by one record per frame,
+* each holding the blend position and the weight of every area quantized to 16 bits.
+*/
+struct SPATIALBLENDAREAS_API FBlendWeightTrace
+{
+	static constexpr uint32 Magic = 0x52545742; // "BWTR"
+	static constexpr uint32 Version = 1;
+
+	/** The names of the recorded areas. Weights of every frame are stored in this order. */
+	TArray<FString> AreaNames;
+
+	TArray<FVector> Positions;
+
+	/** Frame-major weights, AreaNames.Num() values per frame. */
+	TArray<float> Weights;
+
+	int32 GetFrameCount() const { return Positions.Num(); }
+
+	TArrayView<const float> GetFrameWeights(const int32 Frame) const
+	{
+		return MakeArrayView(Weights.GetData() + Frame * AreaNames.Num(), AreaNames.Num());
+	}
+
+	/** The largest error introduced by storing weights with 16 bits. */
+	static constexpr float QuantizationError = 0.5f / MAX_uint16;
+
+	bool LoadFromFile(const FString& FilePath);
+};
+
+/**
+* Streams frames of a FBlendWeightTrace to disk.
+*/
+class SPATIALBLENDAREAS_API FBlendWeightTraceWriter
+{
+public:
+
+	~FBlendWeightTraceWriter();
+
+	bool Open(const FString& FilePath, TArrayView<const FString> AreaNames);
+	void WriteFrame(const FVector& Position, TArrayView<const float> Weights);
+	void Close();
+
+	bool IsOpen() const { return Archive.IsValid(); }
+
+private:
+
+	TUniquePtr<FArchive> Archive;
+	TArray<uint16> QuantizedWeights;
+};
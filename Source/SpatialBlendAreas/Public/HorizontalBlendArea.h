@@ -28,18 +28,52 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	/** The horizontal weight is derived from the squared distance, so index the falloff table with it directly. */
+	virtual EBlendFalloffDomain GetFalloffDomain() const override { return EBlendFalloffDomain::Squared; }
+
+private:
+
+	/** 
+	* The polygon inset by 'BlendDistance'. Every point inside it is at least 'BlendDistance' from the boundary
+	* and thus gets the full weight. Empty when there is no blend distance or the inset collapses or self-intersects.
+	*/
+	TArray<FEdge> InsetEdges;
+	FBox2D InsetBounds = FBox2D(ForceInit);
+
+	/** The weight returned for points at or beyond 'BlendDistance' from the boundary. */
+	float FullWeight = 1.f;
+
+	/** Offsets every ring towards the filled region of the polygon with mitered corners. */
+	void BuildInsetPolygon();
+	bool HasCrossingEdges(TArrayView<const FEdge> InEdges) const;
+
+	/** Returns the weight of a point inside the area from its distance to the boundary. */
+	float GetBlendWeightInside(const FVector2D& Point) const;
+
+	/** Maps the squared distance of a point inside the area from the boundary to its weight. */
+	float GetBlendWeightAtDistanceSquared(const double DistanceSquared) const;
+
 public:	
 
 	virtual void Tick(float DeltaTime) override;
+	virtual void InitializeArea() override;
 
 	/**
 	* Returns a blend weight between 0 and 1 by comparing the 'zero point - input point' -distance to
 	* the 'zero point - max point' -distance. 'Zero point' is the closest point on the polygon boundary
 	* from the input point. 'Max point' is determined by moving from the 'zero point' towards the input point 
 	* the amount specified in the 'BlendDistance' -variable. All checks are done on an XY-plane.
-	* If the input point is outside the blend area, the blend weight is 0.
+	* If the input point is outside the blend area, the blend weight is 0. Without a 'FalloffCurve' the weight
+	* follows the squared ratio of the two distances.
 	*/
 	virtual float GetBlendWeight(const FVector& Point) const override;
+	virtual float GetBlendWeightContained(const FVector& Point) const override;
+
+	/** 
+	* Evaluates the blend weights of a batch of areas of this type, writing zero for null entries. The calls are
+	* bound statically within the translation unit of the type, so they can be inlined into the loop.
+	*/
+	static void EvaluateBatch(TArrayView<const AHorizontalBlendArea* const> Areas, const FVector& Point, TArrayView<float> OutWeights);
 
 #if WITH_EDITORONLY_DATA
 protected:
@@ -56,9 +90,11 @@ protected:
 #endif
 
 #if WITH_EDITOR
-protected:
+public:
 
-	virtual void DebugDraw() const override;
+	virtual void AppendDebugLines(TArray<struct FBatchedLine>& OutLines, TArray<struct FBatchedPoint>& OutPoints) const override;
+	virtual bool HasDynamicDebugDraw() const override;
+	virtual void DrawDynamicDebug() const override;
 
 #endif
 };
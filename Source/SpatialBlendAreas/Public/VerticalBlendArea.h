@@ -28,9 +28,38 @@ protected:
 
 	virtual void BeginPlay() override;
 
+private:
+
+	/** Limits the baked heightfield to MaxStartHeightFieldResolution x MaxStartHeightFieldResolution samples. */
+	static constexpr int32 MaxStartHeightFieldResolution = 128;
+
+	/** Baked terrain heights, row by row along the X-axis, sampled at the corners of the heightfield cells. */
+	UPROPERTY()
+	TArray<float> StartHeightField;
+
+	UPROPERTY()
+	FIntPoint StartHeightFieldResolution = FIntPoint::ZeroValue;
+
+	/** The XY-position of the first sample. */
+	UPROPERTY()
+	FVector2D StartHeightFieldOrigin = FVector2D::ZeroVector;
+
+	UPROPERTY()
+	double StartHeightFieldSpacing = 0.0;
+
+	/** The lowest baked height, for rejecting queries below the whole area with a single comparison. */
+	UPROPERTY()
+	double StartHeightFieldMin = 0.0;
+
+	bool HasStartHeightField() const;
+
+	/** Returns the weight of a point inside the area from its height above the given start height. */
+	float GetBlendWeightAtHeight(const double Height, const double StartHeight) const;
+
 public:	
 
 	virtual void Tick(float DeltaTime) override;
+	virtual void InitializeArea() override;
 
 	/** 
 	* Returns a blend weight between 0 and 1 based on the world space height of the input point
@@ -38,11 +67,36 @@ public:
 	* Returns 0 if the measurement point is outside the blend area on an XY-plane.
 	*/
 	virtual float GetBlendWeight(const FVector& Point) const override;
+	virtual float GetBlendWeightContained(const FVector& Point) const override;
+
+	/** 
+	* Evaluates the blend weights of a batch of areas of this type, writing zero for null entries. The calls are
+	* bound statically within the translation unit of the type, so they can be inlined into the loop.
+	*/
+	static void EvaluateBatch(TArrayView<const AVerticalBlendArea* const> Areas, const FVector& Point, TArrayView<float> OutWeights);
 
-	/** The height in world space below and at which the blend weight is zero. */
+	/** 
+	* The height in world space below and at which the blend weight is zero. 
+	* With 'bUseStartHeightField', the height relative to the baked terrain instead.
+	*/
 	UPROPERTY(EditAnywhere)
 	double BlendStartHeight;
 
+	/** 
+	* Follow the terrain: take the blend start height from a low-resolution heightfield sampled from the landscape
+	* under the area, offset by 'BlendStartHeight'. The heightfield is baked in the editor with 'BakeStartHeightField',
+	* so no traces are done at runtime. Re-bake after moving the area or editing the landscape.
+	*/
+	UPROPERTY(EditAnywhere)
+	bool bUseStartHeightField = false;
+
+	/** The distance between heightfield samples on the XY-plane, used when baking. */
+	UPROPERTY(EditAnywhere, meta = (EditCondition = "bUseStartHeightField", ClampMin = "10.0"))
+	double StartHeightFieldCellSize = 500.0;
+
+	/** Returns the height at and below which the blend weight is zero at the given XY-position. */
+	double GetBlendStartHeight(const FVector2D& Point) const;
+
 #if WITH_EDITORONLY_DATA
 protected:
 
@@ -55,9 +109,13 @@ protected:
 #endif
 
 #if WITH_EDITOR
-protected:
+public:
+
+	virtual void AppendDebugLines(TArray<struct FBatchedLine>& OutLines, TArray<struct FBatchedPoint>& OutPoints) const override;
 
-	virtual void DebugDraw() const override;
+	/** Samples the landscape under the area into the start heightfield. */
+	UFUNCTION(CallInEditor)
+	void BakeStartHeightField();
 
 #endif
 };
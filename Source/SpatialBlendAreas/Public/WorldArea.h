@@ -14,6 +14,28 @@ subjected to the respective product licensing terms.
 #include "GameFramework/Actor.h"
 #include "WorldArea.generated.h"
 
+class AWorldArea;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnWorldAreaGeometryChanged, AWorldArea*);
+
+/** The containment and boundary distance of a point, gathered in a single pass, see AWorldArea::GetSignedDistance(). */
+struct FWorldAreaSignedDistance
+{
+	bool bIsInside = false;
+
+	/** False if no part of the boundary was within the maximum distance of the query. */
+	bool bHasClosestPoint = false;
+
+	/** The closest point on the boundary (the outer ring or any hole). Only valid with 'bHasClosestPoint'. */
+	FVector2D ClosestPoint = FVector2D::ZeroVector;
+
+	/** The squared distance to the closest point, or the maximum distance of the query if there is none. */
+	double DistanceSquared = 0.0;
+
+	/** The distance to the boundary, negative inside the area. */
+	double SignedDistance = 0.0;
+};
+
 UCLASS()
 class SPATIALBLENDAREAS_API AWorldArea : public AActor
 {
@@ -30,15 +52,51 @@ private:
 
 	const double RayLength = 100000000.0;
 
+	/** Limits the number of vertices a single curved spline segment can produce to 2^MaxTessellationDepth. */
+	static constexpr int32 MaxTessellationDepth = 8;
+
 	void InitializeSplineComponent();
-	void InitializeArea();
+
+	/** True if the area was initialized ahead of its BeginPlay. */
+	bool bIsInitializedForPlay = false;
+
+	/** Converts a spline into polygon vertices, tessellating curved segments adaptively. */
+	void TessellateSpline(const class USplineComponent* Spline, TArray<FVector2D>& OutPoints) const;
 
 protected:
 
+	/** 
+	* The maximum distance (in world units) allowed between a curved spline segment and the line segments
+	* approximating it. Smaller values follow curves more closely at the cost of more vertices.
+	* Linear spline points are not affected.
+	*/
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "1.0"))
+	double CurveTessellationTolerance = 50.0;
+
+	/** The polygon vertices of all rings, cached on initialization. */
 	UPROPERTY()
 	TArray<FVector2D> Points;
 
+	/** Ring N uses the vertices [RingOffsets[N], RingOffsets[N + 1]). Ring 0 is the outer boundary, the rest are holes. */
+	TArray<int32> RingOffsets;
+
+	struct FEdge
+	{
+		FVector2D Start;
+		FVector2D End;
+	};
+
+	/** The edges of all rings in one buffer. */
+	TArray<FEdge> Edges;
+
+	/** The XY-bounds of the polygon, valid after InitializeArea(). */
+	FBox2D Bounds = FBox2D(ForceInit);
+
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Checks if a point is inside the polygon formed by an arbitrary set of edges, using the same rules as IsInside(). */
+	bool IsInsideEdges(TArrayView<const FEdge> InEdges, const FVector2D& Point) const;
 
 private:
 
@@ -59,8 +117,34 @@ public:
 
 	virtual void Tick(float DeltaTime) override;
 
+	/** 
+	* Builds the 2D-polygon from the spline. Called automatically on BeginPlay; call it directly when the area
+	* is used outside of play, e.g. from a commandlet.
+	*/
+	virtual void InitializeArea();
+
+	/** 
+	* Initializes the area ahead of its BeginPlay, which then skips the initialization. Used by UBlendAreaSubsystem
+	* to initialize all areas of a world on worker threads, so InitializeArea() overrides must only touch the
+	* state of their own area.
+	*/
+	void InitializeAreaForPlay();
+
+	/** 
+	* Broadcast after the polygon of an area has been rebuilt outside of BeginPlay, e.g. while its spline is being
+	* edited. Structures caching area geometry should patch the entry of that single area in response.
+	*/
+	static FOnWorldAreaGeometryChanged OnGeometryChanged;
+
+	const TArray<FVector2D>& GetPoints() const { return Points; }
+	int32 GetRingCount() const { return FMath::Max(RingOffsets.Num() - 1, 0); }
+	const FBox2D& GetBounds() const { return Bounds; }
+
+	/** Calls the visitor with the start and end point of every edge of every ring. */
+	void ForEachEdge(TFunctionRef<void(const FVector2D&, const FVector2D&)> Visitor) const;
+
 	/**
-	 * Checks if a point is inside the defined polygon. Tests on an XY-plane.
+	 * Checks if a point is inside the defined polygon and outside of all of its holes. Tests on an XY-plane.
 	 *
 	 * @param Point - Point on the XY-plane
 	 */
@@ -68,12 +152,29 @@ public:
 	bool IsInside(const FVector& Point) const;
 
 	/** 
-	* Finds the closest point on the polygon boundary from the provided point and outputs the squared distance to it.
+	* Finds the closest point on the polygon boundary (the outer ring or any hole) from the provided point and outputs the squared distance to it.
 	*
 	* @return true if the polygon has at least one defined vertex
 	*/
 	bool GetClosestPointAndDistanceSquared(const FVector2D& Point, FVector2D& OutClosestPoint, double& OutDistanceSquared) const;
 
+	/** 
+	* Like above, but only considers the boundary within 'MaxDistanceSquared' from the provided point. Edges whose
+	* bounding box is farther away than the closest point found so far are skipped without measuring them.
+	*
+	* @return true if any part of the boundary lies within 'MaxDistanceSquared'
+	*/
+	bool GetClosestPointAndDistanceSquared(const FVector2D& Point, const double MaxDistanceSquared, FVector2D& OutClosestPoint, double& OutDistanceSquared) const;
+
+	/** 
+	* Combines IsInside() and GetClosestPointAndDistanceSquared() in a single pass over the edges: each edge is
+	* tested for crossing the containment ray and measured for the distance in the same iteration. Only the
+	* boundary within 'MaxDistanceSquared' is measured, as in the bounded overload above.
+	*
+	* @return false if the area has no polygon
+	*/
+	bool GetSignedDistance(const FVector2D& Point, FWorldAreaSignedDistance& OutResult, const double MaxDistanceSquared = TNumericLimits<double>::Max()) const;
+
 #if WITH_EDITORONLY_DATA
 protected:
 
@@ -89,9 +190,27 @@ protected:
 #endif
 
 #if WITH_EDITOR
+public:
+
+	/** Also reached from moves and property edits, since AActor reruns the construction script for both. */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	/** 
+	* Appends the static debug visualization of this area to the batched lines drawn by UBlendAreaDebugSubsystem.
+	* Only called when the geometry or the debug settings of an area change.
+	*/
+	virtual void AppendDebugLines(TArray<struct FBatchedLine>& OutLines, TArray<struct FBatchedPoint>& OutPoints) const;
+
+	/** Returns true if the area has debug visualization that changes every frame, see DrawDynamicDebug(). */
+	virtual bool HasDynamicDebugDraw() const { return false; }
+
+	/** Called every frame by UBlendAreaDebugSubsystem for areas with dynamic debug visualization. */
+	virtual void DrawDynamicDebug() const {}
+
 protected:
 
-	virtual void DebugDraw() const;
+	/** Rebuilds the polygon, bounds and edges of this area only and notifies OnGeometryChanged. */
+	void RebuildArea();
 
 #endif
 };
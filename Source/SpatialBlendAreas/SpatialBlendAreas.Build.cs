@@ -49,6 +49,12 @@ public class SpatialBlendAreas : ModuleRules
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
+
+		// Only the editor-time terrain bake of AVerticalBlendArea uses the landscape.
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("Landscape");
+		}
 		
 		
 		DynamicallyLoadedModuleNames.AddRange(
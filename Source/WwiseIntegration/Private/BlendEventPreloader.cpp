@@ -0,0 +1,69 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendEventPreloader.h"
+#include "AkAudioEvent.h"
+#include "Wwise/API/WwiseSoundEngineAPI.h"
+
+void FWwiseEventPreloader::Preload(UAkAudioEvent* Event)
+{
+	if (Event == nullptr)
+	{
+		return;
+	}
+
+	// Events loaded together with their asset already have their media in memory.
+	if (!Event->bAutoLoad)
+	{
+		Event->LoadData();
+	}
+
+	if (IWwiseSoundEngineAPI* SoundEngine = IWwiseSoundEngineAPI::Get())
+	{
+		SoundEngine->PinEventInStreamCache(Event->GetShortID(), AK_DEFAULT_PRIORITY, AK_MIN_PRIORITY);
+	}
+}
+
+void FWwiseEventPreloader::Release(UAkAudioEvent* Event)
+{
+	if (Event == nullptr)
+	{
+		return;
+	}
+
+	if (IWwiseSoundEngineAPI* SoundEngine = IWwiseSoundEngineAPI::Get())
+	{
+		SoundEngine->UnpinEventInStreamCache(Event->GetShortID());
+	}
+
+	if (!Event->bAutoLoad)
+	{
+		Event->UnloadData(true);
+	}
+}
+
+void FRecordingEventPreloader::Preload(UAkAudioEvent* Event)
+{
+	PreloadedEvents.Add(Event);
+	PreloadCount++;
+}
+
+void FRecordingEventPreloader::Release(UAkAudioEvent* Event)
+{
+	PreloadedEvents.Remove(Event);
+	ReleaseCount++;
+}
+
+void FRecordingEventPreloader::Reset()
+{
+	PreloadedEvents.Reset();
+	PreloadCount = 0;
+	ReleaseCount = 0;
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "BlendRtpcSubmitter.h"
+#include "Algo/StableSort.h"
+#include "HAL/IConsoleManager.h"
+#include "Wwise/API/WwiseSoundEngineAPI.h"
+
+void IBlendRtpcSubmitter::CollapseValues(TArrayView<const FBlendRtpcValue> Values, TArray<FBlendRtpcValue>& OutValues)
+{
+	// Stable, so that the last change of an RTPC on a game object stays last among the changes of that RTPC.
+	OutValues.Reset();
+	OutValues.Append(Values.GetData(), Values.Num());
+	Algo::StableSort(OutValues, [](const FBlendRtpcValue& A, const FBlendRtpcValue& B)
+	{
+		return A.GameObjectID != B.GameObjectID ? A.GameObjectID < B.GameObjectID : A.RtpcID < B.RtpcID;
+	});
+
+	// Keep each value that is not overridden by the next one, compacting in place.
+	int32 KeptCount = 0;
+
+	for (int32 Index = 0; Index < OutValues.Num(); Index++)
+	{
+		const bool bIsOverridden = OutValues.IsValidIndex(Index + 1) && OutValues[Index + 1].GameObjectID == OutValues[Index].GameObjectID
+								   && OutValues[Index + 1].RtpcID == OutValues[Index].RtpcID;
+
+		if (!bIsOverridden)
+		{
+			OutValues[KeptCount++] = OutValues[Index];
+		}
+	}
+
+	OutValues.SetNum(KeptCount, false);
+}
+
+void FWwiseRtpcSubmitter::Submit(TArrayView<const FBlendRtpcValue> Values)
+{
+	IWwiseSoundEngineAPI* SoundEngine = IWwiseSoundEngineAPI::Get();
+
+	if (SoundEngine == nullptr)
+	{
+		return;
+	}
+
+	CollapseValues(Values, GroupedValues);
+
+	// The 2022.1 SDK has no entry point for setting several RTPCs in one call, so each value is still set individually.
+	for (const FBlendRtpcValue& RtpcValue : GroupedValues)
+	{
+		SoundEngine->SetRTPCValue(static_cast<AkRtpcID>(RtpcValue.RtpcID), RtpcValue.Value,
+								  static_cast<AkGameObjectID>(RtpcValue.GameObjectID), RtpcValue.InterpolationTimeMs);
+	}
+}
+
+void FRecordingRtpcSubmitter::Submit(TArrayView<const FBlendRtpcValue> Values)
+{
+	CollapseValues(Values, SubmittedValues);
+	SubmitCount++;
+	QueuedValueCount += Values.Num();
+	SetRtpcCallCount += SubmittedValues.Num();
+}
+
+void FRecordingRtpcSubmitter::Reset()
+{
+	SubmittedValues.Reset();
+	SubmitCount = 0;
+	QueuedValueCount = 0;
+	SetRtpcCallCount = 0;
+}
+
+#if !UE_BUILD_SHIPPING
+
+/**
+* Compares the sound engine calls of the per-component and the batched dispatch per frame, through the recording
+* stand-in, which runs the same grouping as FWwiseRtpcSubmitter, so the numbers can be reproduced without the Wwise
+* runtime. Each frame, every component changes its RTPC the given number of times.
+* Usage: WwiseBlendAreas.BenchmarkRtpcDispatch [Components] [ChangesPerFrame] [Frames]
+*/
+static FAutoConsoleCommand BenchmarkRtpcDispatchCommand(
+	TEXT("WwiseBlendAreas.BenchmarkRtpcDispatch"),
+	TEXT("Compares the RTPC calls of per-component and batched dispatch per frame using a recording submitter."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const int32 ComponentCount = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 64;
+		const int32 ChangesPerFrame = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 1;
+		const int32 FrameCount = Args.Num() > 2 ? FMath::Max(FCString::Atoi(*Args[2]), 1) : 1000;
+
+		// The changes of a frame arrive component by component, once per dispatch.
+		TArray<FBlendRtpcValue> Values;
+		Values.SetNum(ComponentCount * ChangesPerFrame);
+
+		for (int32 Change = 0; Change < ChangesPerFrame; Change++)
+		{
+			for (int32 Component = 0; Component < ComponentCount; Component++)
+			{
+				FBlendRtpcValue& Value = Values[Change * ComponentCount + Component];
+				Value.GameObjectID = Component + 1;
+				Value.RtpcID = 1;
+				Value.Value = (Component + Change) % 101;
+			}
+		}
+
+		FRecordingRtpcSubmitter Recorder;
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		for (int32 Frame = 0; Frame < FrameCount; Frame++)
+		{
+			Recorder.Submit(Values);
+		}
+
+		const double BatchedMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) / FrameCount;
+
+		UE_LOG(LogTemp, Display, TEXT("RTPC dispatch of %d components with %d changes each per frame: per-component %d calls, batched %d calls ")
+			   TEXT("in 1 submission (%.4f ms of grouping) per frame over %d frames."), ComponentCount, ChangesPerFrame,
+			   Recorder.QueuedValueCount / FrameCount, Recorder.SetRtpcCallCount / FrameCount, BatchedMs, FrameCount);
+	}));
+
+#endif
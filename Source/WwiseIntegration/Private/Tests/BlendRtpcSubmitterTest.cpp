@@ -0,0 +1,78 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "BlendRtpcSubmitter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBlendRtpcSubmissionTest, "WwiseBlendAreas.RtpcSubmission.CollapseValues",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/**
+* Submits a frame in which some RTPCs change more than once, interleaved across game objects, through the recording
+* stand-in. The submission must be grouped by game object and RTPC, keep only the last change of each, and report
+* fewer calls than the per-component path would make.
+*/
+bool FBlendRtpcSubmissionTest::RunTest(const FString& Parameters)
+{
+	auto MakeValue = [](const uint64 GameObjectID, const uint32 RtpcID, const float Value)
+	{
+		FBlendRtpcValue RtpcValue;
+		RtpcValue.GameObjectID = GameObjectID;
+		RtpcValue.RtpcID = RtpcID;
+		RtpcValue.Value = Value;
+		return RtpcValue;
+	};
+
+	const TArray<FBlendRtpcValue> Values(
+	{
+		MakeValue(2, 1, 10.f),
+		MakeValue(1, 1, 20.f),
+		MakeValue(2, 7, 30.f),
+		MakeValue(2, 1, 40.f),
+		MakeValue(1, 1, 50.f),
+		MakeValue(3, 1, 60.f),
+		MakeValue(2, 1, 70.f)
+	});
+
+	const TArray<FBlendRtpcValue> Expected(
+	{
+		MakeValue(1, 1, 50.f),
+		MakeValue(2, 1, 70.f),
+		MakeValue(2, 7, 30.f),
+		MakeValue(3, 1, 60.f)
+	});
+
+	FRecordingRtpcSubmitter Recorder;
+	Recorder.Submit(Values);
+
+	TestEqual(TEXT("Submissions"), Recorder.SubmitCount, 1);
+	TestEqual(TEXT("Calls of the per-component path"), Recorder.QueuedValueCount, Values.Num());
+	TestEqual(TEXT("Calls of the batched path"), Recorder.SetRtpcCallCount, Expected.Num());
+
+	if (TestEqual(TEXT("Submitted values"), Recorder.SubmittedValues.Num(), Expected.Num()))
+	{
+		for (int32 Index = 0; Index < Expected.Num(); Index++)
+		{
+			const FBlendRtpcValue& Submitted = Recorder.SubmittedValues[Index];
+
+			TestTrue(FString::Printf(TEXT("Submitted value %d"), Index), Submitted.GameObjectID == Expected[Index].GameObjectID
+					 && Submitted.RtpcID == Expected[Index].RtpcID && Submitted.Value == Expected[Index].Value);
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Per-component path: %d calls, batched path: %d calls in %d submission."),
+							Recorder.QueuedValueCount, Recorder.SetRtpcCallCount, Recorder.SubmitCount));
+	return true;
+}
+
+#endif
@@ -0,0 +1,116 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/World.h"
+#include "AkAudioEvent.h"
+#include "AkRtpc.h"
+#include "AkSpatialAudioVolume.h"
+#include "AkStateValue.h"
+#include "BlendWeightTestHelpers.h"
+#include "HorizontalBlendArea.h"
+#include "WwiseBlendAreaEvent.h"
+#include "WwiseBlendWeightTestTypes.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWwiseBlendWeightSteadyStateAllocationTest, "WwiseBlendAreas.BlendWeights.SteadyStateAllocations",
+								 EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+/**
+* Ticks a Wwise manager with batched RTPC submission, room containment, a voice budget and event prefetching along
+* a path that crosses overlapping areas, and back. The RTPCs and events go to the recording stand-ins. The test events
+* have no media, so the start weight is out of reach and the budget only ranks them; posting is not a steady-state
+* cost. After one warm-up pass over the path, a second pass over it must not allocate.
+*/
+bool FWwiseBlendWeightSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace BlendWeightTests;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	TArray<const ABlendArea*> Areas;
+
+	for (int32 Index = 0; Index < 8; Index++)
+	{
+		Areas.Add(SpawnArea(World, FVector2D(Index * 1500.0, (Index % 2) * 500.0), 1000.0, Index % 3));
+	}
+
+	// Off the path, so that the room search runs from outside and is rejected by the bounds.
+	World->SpawnActor<AAkSpatialAudioVolume>(FVector(0.0, 20000.0, 0.0), FRotator::ZeroRotator);
+
+	AWwiseBlendWeightTestManager* Manager = World->SpawnActor<AWwiseBlendWeightTestManager>();
+	FSetProperty* BlendAreasProperty = FindFProperty<FSetProperty>(UWwiseBlendAreaEvent::StaticClass(), TEXT("BlendAreas"));
+	UAkRtpc* BlendParameter = NewObject<UAkRtpc>(GetTransientPackage());
+
+	// Each event blends in two neighbouring areas, and two events share an event asset.
+	for (int32 Index = 0; Index < Manager->Events.Num(); Index++)
+	{
+		UWwiseBlendAreaEvent* Event = Manager->Events[Index];
+		TSet<const ABlendArea*>* EventAreas = BlendAreasProperty->ContainerPtrToValuePtr<TSet<const ABlendArea*>>(Event);
+		EventAreas->Add(Areas[Index * 2]);
+		EventAreas->Add(Areas[Index * 2 + 1]);
+
+		SetObjectProperty(Event, TEXT("BlendParameter"), BlendParameter);
+		Event->AkAudioEvent = Index % 2 == 0 ? NewObject<UAkAudioEvent>(GetTransientPackage()) : Manager->Events[Index - 1]->AkAudioEvent;
+	}
+
+	Manager->bUseVoiceBudget = true;
+	Manager->MaxActiveEvents = 2;
+	Manager->StartWeight = 2.f;
+	Manager->bPrefetchEvents = true;
+	Manager->PrefetchLeadTime = 1.f;
+	Manager->PrefetchReleaseDelay = 0.5f;
+	Manager->PrefetchCheckInterval = 0.f;
+	SetObjectProperty(Manager, TEXT("InsideRoomState"), NewObject<UAkStateValue>(GetTransientPackage()));
+	SetObjectProperty(Manager, TEXT("NoneState"), NewObject<UAkStateValue>(GetTransientPackage()));
+
+	const TSharedRef<FRecordingRtpcSubmitter> RtpcSubmitter = MakeShared<FRecordingRtpcSubmitter>();
+	const TSharedRef<FRecordingEventPreloader> EventPreloader = MakeShared<FRecordingEventPreloader>();
+	Manager->SetRtpcSubmitter(RtpcSubmitter);
+	Manager->SetEventPreloader(EventPreloader);
+
+	BeginPlay(World);
+
+	TArray<FVector> Path;
+
+	for (int32 Step = 0; Step < 256; Step++)
+	{
+		Path.Emplace(-2000.0 + Step * 60.0, FMath::Sin(Step * 0.1) * 1200.0, 0.0);
+	}
+
+	for (int32 Step = Path.Num() - 1; Step >= 0; Step--)
+	{
+		const FVector Position = Path[Step];
+		Path.Add(Position);
+	}
+
+	auto RunPath = [&]()
+	{
+		for (const FVector& Position : Path)
+		{
+			Manager->BlendPosition = Position;
+			Manager->Tick(1.f / 30.f);
+		}
+	};
+
+	RunPath();
+	RtpcSubmitter->Reset();
+	EventPreloader->Reset();
+
+	TestEqual(TEXT("Allocations during the steady-state ticks"), CountAllocations(RunPath), 0);
+	TestTrue(TEXT("The blend RTPCs were submitted"), RtpcSubmitter->SetRtpcCallCount > 0);
+	TestTrue(TEXT("The events were prefetched"), EventPreloader->PreloadCount > 0);
+
+	DestroyWorld(World);
+	return true;
+}
+
+#endif
@@ -0,0 +1,22 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#include "WwiseBlendWeightTestTypes.h"
+#include "WwiseBlendAreaEvent.h"
+
+AWwiseBlendWeightTestManager::AWwiseBlendWeightTestManager()
+{
+	for (int32 Index = 0; Index < EventCount; Index++)
+	{
+		Events.Add(CreateDefaultSubobject<UWwiseBlendAreaEvent>(*FString::Printf(TEXT("Event%d"), Index)));
+	}
+
+	SmoothingTimeConstant = 0.2f;
+}
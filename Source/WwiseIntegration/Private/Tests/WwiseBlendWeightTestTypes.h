@@ -0,0 +1,42 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WwiseBlendWeightManager.h"
+#include "WwiseBlendWeightTestTypes.generated.h"
+
+class UWwiseBlendAreaEvent;
+
+/** 
+* A Wwise manager with a fixed set of blend area events, following a position set by the test instead of a Wwise
+* listener. Only used by the automation tests.
+*/
+UCLASS(NotBlueprintable, NotPlaceable, Transient)
+class AWwiseBlendWeightTestManager : public AWwiseBlendWeightManager
+{
+	GENERATED_BODY()
+
+public:
+
+	AWwiseBlendWeightTestManager();
+
+	static constexpr int32 EventCount = 4;
+
+	UPROPERTY()
+	TArray<UWwiseBlendAreaEvent*> Events;
+
+	FVector BlendPosition = FVector::ZeroVector;
+
+protected:
+
+	virtual void GetBlendPosition(FVector& OutPosition) const override { OutPosition = BlendPosition; }
+};
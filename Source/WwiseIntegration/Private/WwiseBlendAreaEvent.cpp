@@ -9,6 +9,7 @@ subjected to the respective product licensing terms.
 ******************************************************************************************************/
 
 #include "WwiseBlendAreaEvent.h"
+#include "WwiseBlendWeightManager.h"
 
 void UWwiseBlendAreaEvent::BeginPlay()
 {
@@ -18,12 +19,18 @@ void UWwiseBlendAreaEvent::BeginPlay()
 	SetWeight(0.f);
 	SetStopWhenOwnerDestroyed(true);
 
-	if (AkAudioEvent != nullptr && !bStopWhenZeroWeight)
+	if (AkAudioEvent != nullptr && !bStopWhenZeroWeight && !IsLifetimeManaged())
 	{
 		PostAkEvent(AkAudioEvent);		
 	}
 }
 
+void UWwiseBlendAreaEvent::OnRegister()
+{
+	Super::OnRegister();
+	OwningManager = Cast<AWwiseBlendWeightManager>(GetOwner());
+}
+
 void UWwiseBlendAreaEvent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
@@ -31,11 +38,35 @@ void UWwiseBlendAreaEvent::TickComponent(float DeltaTime, ELevelTick TickType, F
 
 void UWwiseBlendAreaEvent::SetWeight(const float& Weight)
 {
+	CurrentWeight = Weight;
+
 	if (IsValid(BlendParameter))
 	{
 		// Wwise has a convention of using the 0 to 100 range for RTPCs, so let's follow that.
 		float Percentage = Weight * 100;
-		this->SetRTPCValue(BlendParameter, Percentage, 0, FString());
+
+		if (Percentage != LastSubmittedPercentage)
+		{
+			LastSubmittedPercentage = Percentage;
+
+			FBlendRtpcValue RtpcValue;
+			RtpcValue.GameObjectID = GetAkGameObjectID();
+			RtpcValue.RtpcID = BlendParameter->GetShortID();
+			RtpcValue.Value = Percentage;
+			RtpcValue.InterpolationTimeMs = OwningManager != nullptr ? OwningManager->GetRtpcInterpolationTimeMs() : 0;
+
+			// Prefer the batched submission of the owning manager, fall back to setting the value directly.
+			if (OwningManager == nullptr || !OwningManager->QueueRtpcValue(RtpcValue))
+			{
+				this->SetRTPCValue(BlendParameter, Percentage, RtpcValue.InterpolationTimeMs, FString());
+			}
+		}
+	}
+
+	// When the owning manager enforces a voice budget, it decides when to post and stop the event.
+	if (IsLifetimeManaged())
+	{
+		return;
 	}
 
 	if (Weight > 0 && AkAudioEvent != nullptr && !HasActiveEvents())
@@ -48,12 +79,38 @@ void UWwiseBlendAreaEvent::SetWeight(const float& Weight)
 	}
 }
 
+bool UWwiseBlendAreaEvent::IsLifetimeManaged() const
+{
+	return OwningManager != nullptr && OwningManager->bUseVoiceBudget;
+}
+
+bool UWwiseBlendAreaEvent::StartBlendEvent()
+{
+	if (AkAudioEvent == nullptr)
+	{
+		return false;
+	}
+
+	ActiveTime = 0.f;
+	BlendEventState = EBlendEventState::Playing;
+	PostAkEvent(AkAudioEvent);
+	return true;
+}
+
+void UWwiseBlendAreaEvent::StopBlendEvent()
+{
+	ActiveTime = 0.f;
+	BlendEventState = EBlendEventState::Stopping;
+	Stop();
+}
+
 bool UWwiseBlendAreaEvent::GetWeight(float& OutWeight) const
 {
 	if (IsValid(BlendParameter))
 	{
-		ERTPCValueType OutValueType;
-		this->GetRTPCValue(BlendParameter, ERTPCValueType::GameObject, OutWeight, OutValueType, FString());
+		// The RTPC value last set, in the same 0 to 100 range as before, but without a read back from the sound engine.
+		// The value does not follow an interpolation done in the sound engine.
+		OutWeight = CurrentWeight * 100;
 		return true;
 	}
 
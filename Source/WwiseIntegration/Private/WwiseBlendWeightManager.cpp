@@ -11,6 +11,15 @@ subjected to the respective product licensing terms.
 #include "WwiseBlendWeightManager.h"
 #include "AkAudioDevice.h"
 #include "AkComponent.h"
+#include "AkRoomComponent.h"
+#include "Engine/World.h"
+#include "UObject/UObjectIterator.h"
+#include "WwiseBlendAreaEvent.h"
+
+DECLARE_STATS_GROUP(TEXT("WwiseBlendAreas"), STATGROUP_WwiseBlendAreas, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Blend Area Events"), STAT_ActiveBlendAreaEvents, STATGROUP_WwiseBlendAreas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Blend Area Event Churn Per Second"), STAT_BlendAreaEventChurn, STATGROUP_WwiseBlendAreas);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Prefetched Blend Area Events"), STAT_PrefetchedBlendAreaEvents, STATGROUP_WwiseBlendAreas);
 
 AWwiseBlendWeightManager::AWwiseBlendWeightManager()
 	: bUseSpatialAudioListener(false)
@@ -21,11 +30,38 @@ AWwiseBlendWeightManager::AWwiseBlendWeightManager()
 void AWwiseBlendWeightManager::BeginPlay()
 {
 	Super::BeginPlay();
+
+	if (!RtpcSubmitter.IsValid())
+	{
+		RtpcSubmitter = MakeShared<FWwiseRtpcSubmitter>();
+	}
+
+	if (!EventPreloader.IsValid())
+	{
+		EventPreloader = MakeShared<FWwiseEventPreloader>();
+	}
+
+	GetComponents(BlendAreaEvents);
+	QueuedRtpcValues.Reserve(BlendAreaEvents.Num());
+	RankedEvents.Reserve(BlendAreaEvents.Num());
+	PrefetchedAudioEvents.Init(nullptr, BlendAreaEvents.Num());
+	PrefetchIdleTimes.Init(0.f, BlendAreaEvents.Num());
+	PrefetchReferences.Reserve(BlendAreaEvents.Num());
+	CachedRooms.Reserve(ExpectedOverlappingRooms);
+
+	RefreshRooms();
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &AWwiseBlendWeightManager::OnLevelsChanged);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &AWwiseBlendWeightManager::OnLevelsChanged);
 }
 
 void AWwiseBlendWeightManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
 	Super::EndPlay(EndPlayReason);
+	ReleasePrefetchedEvents();
+
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+	WorldRooms.Reset();
 
 	if (NoneState != nullptr)
 	{
@@ -42,42 +78,165 @@ void AWwiseBlendWeightManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (!(Timer >= RoomContainmentCheckInterval))
+	if (bUseVoiceBudget)
 	{
-		Timer += DeltaTime;
-		return;
+		UpdateEventLifetimes(DeltaTime);
 	}
 
-	Timer = 0.f;
+	if (bPrefetchEvents)
+	{
+		UpdatePrefetch(DeltaTime);
+	}
+
+	SubmitQueuedRtpcValues();
+
+	UpdateRoomContainment(DeltaTime);
+}
+
+void AWwiseBlendWeightManager::UpdateRoomContainment(float DeltaTime)
+{
 	FAkAudioDevice* AudioDevice = FAkAudioDevice::Get();
 	
-	if (AudioDevice != nullptr && InsideRoomState != nullptr && NoneState != nullptr)
+	if (AudioDevice == nullptr || InsideRoomState == nullptr || NoneState == nullptr)
+	{
+		return;
+	}
+
+	if (!AudioDevice->UsingSpatialAudioRooms(this->GetWorld()))
 	{
-		if (!AudioDevice->UsingSpatialAudioRooms(this->GetWorld()) && bInsideRoom)
+		if (bInsideRoom)
 		{
-			AudioDevice->SetState(NoneState);
-			bInsideRoom = false;
+			OnRoomExited();
 		}
-		else
+
+		return;
+	}
+
+	FVector Position;
+	GetBlendPosition(Position);
+
+	// Common case: the listener is still inside one of the rooms it was found in, which is cheap to re-validate.
+	if (bInsideRoom && IsInsideCachedRoom(Position))
+	{
+		return;
+	}
+
+	// While outside of all rooms, the full search is only needed for detecting an entry, so it can be throttled.
+	if (!bInsideRoom)
+	{
+		if (!(Timer >= RoomContainmentCheckInterval))
 		{
-			FVector Position;
-			GetBlendPosition(Position);
-			TArray<UAkRoomComponent*> Rooms = AudioDevice->FindRoomComponentsAtLocation(Position, this->GetWorld());
+			Timer += DeltaTime;
+			return;
+		}
 
-			if (Rooms.Num() == 0 && bInsideRoom)
-			{
-				AudioDevice->SetState(NoneState);
-				bInsideRoom = false;
-			}
-			else if (Rooms.Num() > 0 && !bInsideRoom)
-			{
-				AudioDevice->SetState(InsideRoomState);
-				bInsideRoom = true;
-			}
+		Timer = 0.f;
+	}
+
+	// Only reached when entering, leaving or searching from outside of the rooms.
+	FindRoomsAtLocation(Position);
+
+	if (CachedRooms.Num() == 0 && bInsideRoom)
+	{
+		OnRoomExited();
+	}
+	else if (CachedRooms.Num() > 0 && !bInsideRoom)
+	{
+		OnRoomEntered();
+	}
+}
+
+void AWwiseBlendWeightManager::RefreshRooms()
+{
+	WorldRooms.Reset();
+	CachedRooms.Reset();
+
+	for (TObjectIterator<UAkRoomComponent> It; It; ++It)
+	{
+		if (It->GetWorld() == GetWorld() && !It->IsTemplate())
+		{
+			WorldRooms.Add(*It);
 		}
 	}
 }
 
+void AWwiseBlendWeightManager::OnLevelsChanged(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		RefreshRooms();
+	}
+}
+
+void AWwiseBlendWeightManager::FindRoomsAtLocation(const FVector& Position)
+{
+	CachedRooms.Reset();
+
+	// The bounds reject every room in the common case of being outside all of them, without allocating,
+	// which FAkAudioDevice::FindRoomComponentsAtLocation() cannot avoid as it returns a new array.
+	for (const auto& WorldRoom : WorldRooms)
+	{
+		UAkRoomComponent* Room = WorldRoom.Get();
+
+		if (IsInsideRoom(Room, Position))
+		{
+			CachedRooms.Add(Room);
+		}
+	}
+}
+
+bool AWwiseBlendWeightManager::IsInsideCachedRoom(const FVector& Position) const
+{
+	for (const auto& CachedRoom : CachedRooms)
+	{
+		if (IsInsideRoom(CachedRoom.Get(), Position))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool AWwiseBlendWeightManager::IsInsideRoom(const UAkRoomComponent* Room, const FVector& Position)
+{
+	if (Room == nullptr || !Room->RoomIsActive())
+	{
+		return false;
+	}
+
+	const UPrimitiveComponent* RoomPrimitive = Room->GetPrimitiveParent();
+
+	if (RoomPrimitive != nullptr && !RoomPrimitive->Bounds.GetBox().IsInsideOrOn(Position))
+	{
+		return false;
+	}
+
+	return Room->HasEffectOnLocation(Position);
+}
+
+void AWwiseBlendWeightManager::OnRoomEntered()
+{
+	bInsideRoom = true;
+
+	if (FAkAudioDevice* AudioDevice = FAkAudioDevice::Get())
+	{
+		AudioDevice->SetState(InsideRoomState);
+	}
+}
+
+void AWwiseBlendWeightManager::OnRoomExited()
+{
+	bInsideRoom = false;
+	CachedRooms.Reset();
+	Timer = 0.f;
+
+	if (FAkAudioDevice* AudioDevice = FAkAudioDevice::Get())
+	{
+		AudioDevice->SetState(NoneState);
+	}
+}
+
 void AWwiseBlendWeightManager::GetBlendPosition(FVector& OutPosition) const
 {
 	OutPosition = FVector::ZeroVector;
@@ -96,7 +255,8 @@ void AWwiseBlendWeightManager::GetBlendPosition(FVector& OutPosition) const
 		}
 		else
 		{
-			UAkComponentSet Listeners = AudioDevice->GetDefaultListeners();
+			// Bind by reference, copying the set would allocate on every call.
+			const UAkComponentSet& Listeners = AudioDevice->GetDefaultListeners();
 
 			for (const auto& Listener : Listeners)
 			{
@@ -108,3 +268,294 @@ void AWwiseBlendWeightManager::GetBlendPosition(FVector& OutPosition) const
 		}
 	}
 }
+
+bool AWwiseBlendWeightManager::ShouldSmoothWeights() const
+{
+	return !bInterpolateRtpcInSoundEngine && Super::ShouldSmoothWeights();
+}
+
+int32 AWwiseBlendWeightManager::GetRtpcInterpolationTimeMs() const
+{
+	return bInterpolateRtpcInSoundEngine ? FMath::RoundToInt(SmoothingTimeConstant * 1000.f) : 0;
+}
+
+bool AWwiseBlendWeightManager::QueueRtpcValue(const FBlendRtpcValue& RtpcValue)
+{
+	if (!bBatchRtpcSubmission)
+	{
+		return false;
+	}
+
+	QueuedRtpcValues.Add(RtpcValue);
+	return true;
+}
+
+void AWwiseBlendWeightManager::SetRtpcSubmitter(TSharedPtr<IBlendRtpcSubmitter> InRtpcSubmitter)
+{
+	RtpcSubmitter = InRtpcSubmitter;
+}
+
+void AWwiseBlendWeightManager::SetEventPreloader(TSharedPtr<IBlendEventPreloader> InEventPreloader)
+{
+	// Hand the events preloaded so far back to the loader that preloaded them.
+	ReleasePrefetchedEvents();
+	EventPreloader = InEventPreloader;
+}
+
+void AWwiseBlendWeightManager::SubmitQueuedRtpcValues()
+{
+	if (QueuedRtpcValues.Num() == 0)
+	{
+		return;
+	}
+
+	if (RtpcSubmitter.IsValid())
+	{
+		RtpcSubmitter->Submit(QueuedRtpcValues);
+	}
+
+	QueuedRtpcValues.Reset();
+}
+
+void AWwiseBlendWeightManager::UpdateEventLifetimes(float DeltaTime)
+{
+	RankedEvents.Reset();
+
+	for (int32 Index = 0; Index < BlendAreaEvents.Num(); Index++)
+	{
+		if (IsValid(BlendAreaEvents[Index]))
+		{
+			RankedEvents.Add(Index);
+		}
+	}
+
+	// Rank by weight; on equal weight prefer the events that are already playing to avoid needless swaps.
+	RankedEvents.Sort([this](const int32 A, const int32 B)
+	{
+		const UWwiseBlendAreaEvent* EventA = BlendAreaEvents[A];
+		const UWwiseBlendAreaEvent* EventB = BlendAreaEvents[B];
+
+		if (EventA->GetCurrentWeight() != EventB->GetCurrentWeight())
+		{
+			return EventA->GetCurrentWeight() > EventB->GetCurrentWeight();
+		}
+
+		return EventA->IsBlendEventPlaying() && !EventB->IsBlendEventPlaying();
+	});
+
+	// Events within their minimum lifetime are kept whatever their rank, so they take their slots first.
+	int32 ProtectedCount = 0;
+
+	for (const int32 Index : RankedEvents)
+	{
+		UWwiseBlendAreaEvent* Event = BlendAreaEvents[Index];
+
+		// A playing event may also end on its own, and a stopping one ends once it has faded out.
+		if (Event->BlendEventState != UWwiseBlendAreaEvent::EBlendEventState::Stopped && !Event->HasActiveEvents())
+		{
+			Event->BlendEventState = UWwiseBlendAreaEvent::EBlendEventState::Stopped;
+		}
+
+		if (Event->IsBlendEventPlaying())
+		{
+			Event->ActiveTime += DeltaTime;
+			ProtectedCount += Event->ActiveTime < MinimumEventLifetime ? 1 : 0;
+		}
+	}
+
+	const int32 EventLimit = MaxActiveEvents > 0 ? MaxActiveEvents : MAX_int32;
+	int32 FreeSlots = FMath::Max(EventLimit - ProtectedCount, 0);
+	ActiveEventCount = 0;
+
+	for (const int32 Index : RankedEvents)
+	{
+		UWwiseBlendAreaEvent* Event = BlendAreaEvents[Index];
+		const bool bIsPlaying = Event->IsBlendEventPlaying();
+		const float Weight = Event->GetCurrentWeight();
+
+		// Enter and exit thresholds differ, so that an event hovering around a single weight value does not thrash.
+		// A stopping event is treated as stopped, so it is posted again if its weight rises during the fade-out.
+		const bool bWantsToPlay = bIsPlaying ? Weight > StopWeight : (Weight > 0 && Weight >= StartWeight);
+
+		if (bIsPlaying)
+		{
+			if (Event->ActiveTime < MinimumEventLifetime)
+			{
+				ActiveEventCount++;
+				continue;
+			}
+
+			if (bWantsToPlay && FreeSlots > 0)
+			{
+				FreeSlots--;
+				ActiveEventCount++;
+				continue;
+			}
+
+			Event->StopBlendEvent();
+			EventChurnCount++;
+		}
+		else if (bWantsToPlay && FreeSlots > 0 && Event->StartBlendEvent())
+		{
+			FreeSlots--;
+			ActiveEventCount++;
+			EventChurnCount++;
+		}
+	}
+
+	EventChurnTimer += DeltaTime;
+
+	if (EventChurnTimer >= 1.f)
+	{
+		EventChurnPerSecond = EventChurnCount / EventChurnTimer;
+		EventChurnCount = 0;
+		EventChurnTimer = 0.f;
+	}
+
+	SET_DWORD_STAT(STAT_ActiveBlendAreaEvents, ActiveEventCount);
+	SET_FLOAT_STAT(STAT_BlendAreaEventChurn, EventChurnPerSecond);
+}
+
+void AWwiseBlendWeightManager::UpdatePrefetch(float DeltaTime)
+{
+	FVector Position;
+	GetBlendPosition(Position);
+
+	if (bHasPreviousListenerPosition && DeltaTime > 0.f)
+	{
+		// Smooth the velocity over roughly a quarter of a second, so single-frame jumps do not trigger preloads.
+		const FVector2D FrameVelocity = FVector2D(Position - PreviousListenerPosition) / DeltaTime;
+		ListenerVelocity = FMath::Lerp(ListenerVelocity, FrameVelocity, FMath::Min(DeltaTime / 0.25f, 1.f));
+	}
+
+	PreviousListenerPosition = Position;
+	bHasPreviousListenerPosition = true;
+	PrefetchTimer += DeltaTime;
+
+	if (PrefetchTimer < PrefetchCheckInterval || !EventPreloader.IsValid())
+	{
+		return;
+	}
+
+	const float ElapsedTime = PrefetchTimer;
+	PrefetchTimer = 0.f;
+
+	// Acquire before releasing, so that an event handed over from one component to another stays loaded in between.
+	for (int32 Index = 0; Index < BlendAreaEvents.Num(); Index++)
+	{
+		UWwiseBlendAreaEvent* Event = BlendAreaEvents[Index];
+
+		if (!IsValid(Event))
+		{
+			continue;
+		}
+
+		// A playing or fading event is using its data, whatever its weight.
+		const bool bIsNeeded = Event->AkAudioEvent != nullptr && (Event->HasActiveEvents() || Event->GetCurrentWeight() > 0
+							   || EstimateTimeToEntry(Event, FVector2D(Position.X, Position.Y)) <= PrefetchLeadTime);
+
+		if (bIsNeeded)
+		{
+			if (PrefetchedAudioEvents[Index] == nullptr)
+			{
+				AcquirePrefetch(Index, Event->AkAudioEvent);
+			}
+
+			PrefetchIdleTimes[Index] = 0.f;
+		}
+		else if (PrefetchedAudioEvents[Index] != nullptr)
+		{
+			PrefetchIdleTimes[Index] += ElapsedTime;
+		}
+	}
+
+	for (int32 Index = 0; Index < BlendAreaEvents.Num(); Index++)
+	{
+		if (PrefetchedAudioEvents[Index] != nullptr && (PrefetchIdleTimes[Index] >= PrefetchReleaseDelay || !IsValid(BlendAreaEvents[Index])))
+		{
+			ReleasePrefetch(Index);
+		}
+	}
+
+	SET_DWORD_STAT(STAT_PrefetchedBlendAreaEvents, PrefetchedEventCount);
+}
+
+float AWwiseBlendWeightManager::EstimateTimeToEntry(const UWwiseBlendAreaEvent* Event, const FVector2D& Position) const
+{
+	// Areas farther away than the listener can travel within the lead time are skipped without touching their edges.
+	const double Reach = ListenerVelocity.Size() * PrefetchLeadTime;
+	float TimeToEntry = MAX_flt;
+
+	for (const ABlendArea* Area : Event->GetBlendAreas())
+	{
+		if (!IsValid(Area) || !Area->GetBounds().bIsValid || Area->GetBounds().ComputeSquaredDistanceToPoint(Position) > Reach * Reach)
+		{
+			continue;
+		}
+
+		if (Area->IsInside(Position))
+		{
+			return 0.f;
+		}
+
+		FVector2D ClosestPoint;
+		double DistanceSquared = 0.0;
+
+		if (!Area->GetClosestPointAndDistanceSquared(Position, ClosestPoint, DistanceSquared) || DistanceSquared <= 0.0)
+		{
+			continue;
+		}
+
+		// Only the velocity component towards the closest boundary point brings the listener closer to the area.
+		const double Distance = FMath::Sqrt(DistanceSquared);
+		const double ClosingSpeed = (ListenerVelocity | (ClosestPoint - Position)) / Distance;
+
+		if (ClosingSpeed > KINDA_SMALL_NUMBER)
+		{
+			TimeToEntry = FMath::Min(TimeToEntry, static_cast<float>(Distance / ClosingSpeed));
+		}
+	}
+
+	return TimeToEntry;
+}
+
+void AWwiseBlendWeightManager::ReleasePrefetchedEvents()
+{
+	for (int32 Index = 0; Index < PrefetchedAudioEvents.Num(); Index++)
+	{
+		if (PrefetchedAudioEvents[Index] != nullptr)
+		{
+			ReleasePrefetch(Index);
+		}
+	}
+}
+
+void AWwiseBlendWeightManager::AcquirePrefetch(const int32 Index, UAkAudioEvent* AudioEvent)
+{
+	PrefetchedAudioEvents[Index] = AudioEvent;
+	int32& References = PrefetchReferences.FindOrAdd(AudioEvent);
+
+	if (References++ == 0)
+	{
+		EventPreloader->Preload(AudioEvent);
+		PrefetchedEventCount++;
+	}
+}
+
+void AWwiseBlendWeightManager::ReleasePrefetch(const int32 Index)
+{
+	UAkAudioEvent* AudioEvent = PrefetchedAudioEvents[Index];
+	PrefetchedAudioEvents[Index] = nullptr;
+	PrefetchIdleTimes[Index] = 0.f;
+	int32& References = PrefetchReferences.FindChecked(AudioEvent);
+
+	if (--References == 0)
+	{
+		if (EventPreloader.IsValid())
+		{
+			EventPreloader->Release(AudioEvent);
+		}
+
+		PrefetchedEventCount--;
+	}
+}
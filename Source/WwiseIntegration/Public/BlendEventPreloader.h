@@ -0,0 +1,66 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UAkAudioEvent;
+
+/**
+* The point at which AWwiseBlendWeightManager asks for the data of an event to be made ready ahead of the
+* listener entering one of its blend areas, and later released again. Calls are balanced per event, and an event
+* is not preloaded again before it has been released, even when several components share it.
+*/
+class WWISEINTEGRATION_API IBlendEventPreloader
+{
+public:
+
+	virtual ~IBlendEventPreloader() = default;
+
+	/** Starts loading the data of an event without blocking. */
+	virtual void Preload(UAkAudioEvent* Event) = 0;
+
+	/** Releases the data requested by a previous Preload() call. */
+	virtual void Release(UAkAudioEvent* Event) = 0;
+};
+
+/**
+* Loads the media of events that are not loaded automatically through the asynchronous Wwise resource loader,
+* and pins the beginning of the streamed media of the event in the sound engine's stream cache, so that
+* posting the event does not wait for the first stream buffers.
+*/
+class WWISEINTEGRATION_API FWwiseEventPreloader : public IBlendEventPreloader
+{
+public:
+
+	virtual void Preload(UAkAudioEvent* Event) override;
+	virtual void Release(UAkAudioEvent* Event) override;
+};
+
+/**
+* A stand-in that only records what it is asked to do. Useful for testing and tuning the prefetch
+* without the Wwise runtime.
+*/
+class WWISEINTEGRATION_API FRecordingEventPreloader : public IBlendEventPreloader
+{
+public:
+
+	virtual void Preload(UAkAudioEvent* Event) override;
+	virtual void Release(UAkAudioEvent* Event) override;
+
+	void Reset();
+
+	/** The events currently preloaded. */
+	TSet<const UAkAudioEvent*> PreloadedEvents;
+
+	int32 PreloadCount = 0;
+	int32 ReleaseCount = 0;
+};
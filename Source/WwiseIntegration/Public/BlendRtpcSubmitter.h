@@ -0,0 +1,85 @@
+/*****************************************************************************************************
+Spatial Blend Areas
+Copyright 2022 Ville Ojala
+Apache License, Version 2.0
+
+The plugin contains dependencies to Unreal Engine by Epic Games Inc. and AUDIOKINETIC Wwise Technology
+by Audiokinetic Inc. (the latter applies only to the 'WwiseIntegration' -module), the use of which is
+subjected to the respective product licensing terms.
+******************************************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* A single game object scoped RTPC value change. Plain integer ids are used instead of the Wwise SDK typedefs,
+* so that this header (and any stand-in submitter) compiles without the Wwise runtime.
+*/
+struct WWISEINTEGRATION_API FBlendRtpcValue
+{
+	uint64 GameObjectID = 0;
+	uint32 RtpcID = 0;
+	float Value = 0.f;
+	int32 InterpolationTimeMs = 0;
+};
+
+/**
+* The point at which AWwiseBlendWeightManager hands the RTPC changes of a frame over to the sound engine.
+*/
+class WWISEINTEGRATION_API IBlendRtpcSubmitter
+{
+public:
+
+	virtual ~IBlendRtpcSubmitter() = default;
+
+	/** Submits all values gathered during a frame. */
+	virtual void Submit(TArrayView<const FBlendRtpcValue> Values) = 0;
+
+	/** 
+	* Groups the values of a frame by game object and RTPC into OutValues, keeping only the last change of each RTPC
+	* on each game object. Every submitter runs its values through this, so a stand-in sees the calls Wwise would.
+	*/
+	static void CollapseValues(TArrayView<const FBlendRtpcValue> Values, TArray<FBlendRtpcValue>& OutValues);
+};
+
+/**
+* Passes the values of a frame to the Wwise sound engine, bypassing the per-component UAkComponent::SetRTPCValue() path.
+* The 2022.1 SDK has no multi-value or bus-level RTPC setter, so every value is still one SetRTPCValue() call;
+* the values are grouped by game object and repeated changes of the same RTPC within a frame collapse into one call.
+*/
+class WWISEINTEGRATION_API FWwiseRtpcSubmitter : public IBlendRtpcSubmitter
+{
+public:
+
+	virtual void Submit(TArrayView<const FBlendRtpcValue> Values) override;
+
+private:
+
+	/** The values of the current submission grouped by game object, reused from frame to frame. */
+	TArray<FBlendRtpcValue> GroupedValues;
+};
+
+/**
+* A stand-in that records the calls FWwiseRtpcSubmitter would make, without the Wwise runtime. Useful for testing
+* and for comparing the batched submission against the per-component path.
+*/
+class WWISEINTEGRATION_API FRecordingRtpcSubmitter : public IBlendRtpcSubmitter
+{
+public:
+
+	virtual void Submit(TArrayView<const FBlendRtpcValue> Values) override;
+
+	void Reset();
+
+	/** The values of the latest submission, grouped and collapsed as the sound engine would receive them. */
+	TArray<FBlendRtpcValue> SubmittedValues;
+
+	int32 SubmitCount = 0;
+
+	/** The values handed in over all submissions. The per-component path makes one SetRTPCValue() call for each. */
+	int32 QueuedValueCount = 0;
+
+	/** The SetRTPCValue() calls made over all submissions. */
+	int32 SetRtpcCallCount = 0;
+};
@@ -16,6 +16,8 @@ subjected to the respective product licensing terms.
 #include "BlendArea.h"
 #include "WwiseBlendAreaEvent.generated.h"
 
+class AWwiseBlendWeightManager;
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class WWISEINTEGRATION_API UWwiseBlendAreaEvent : public UAkComponent, public IBlendWeightInterface
 {
@@ -25,21 +27,69 @@ public:
 
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 	virtual void SetWeight(const float& Weight) override;
+
+	/** Returns the blend RTPC value last set, in the 0 to 100 range, or false if there is no BlendParameter. */
 	virtual bool GetWeight(float& OutWeight) const override;
 	const virtual TSet<const ABlendArea*>& GetBlendAreas() const override;
 
+	/** Ignored when the owning AWwiseBlendWeightManager enforces a voice budget. */
 	UPROPERTY(EditAnywhere)
 	bool bStopWhenZeroWeight = false;
 
+	/** Returns true if the owning manager decides when the event is posted and stopped. */
+	bool IsLifetimeManaged() const;
+
+	/** Posts the event on behalf of the owning manager. */
+	bool StartBlendEvent();
+
+	/** Stops the event on behalf of the owning manager. The event keeps sounding while it fades out. */
+	void StopBlendEvent();
+
+	/** The weight passed in on the latest SetWeight() call, in the 0 to 1 range. */
+	float GetCurrentWeight() const { return CurrentWeight; }
+
+	/** True from StartBlendEvent() until StopBlendEvent() or until the event has ended on its own. */
+	bool IsBlendEventPlaying() const { return BlendEventState == EBlendEventState::Playing; }
+
+	/** True from StopBlendEvent() until the stopped event has finished fading out. */
+	bool IsBlendEventStopping() const { return BlendEventState == EBlendEventState::Stopping; }
+
+	/** Seconds since the event was last started by the owning manager. */
+	float GetActiveTime() const { return ActiveTime; }
+
 protected:
 
 	virtual void BeginPlay() override;
+	virtual void OnRegister() override;
 
 private:
 
+	/** The owner, if it is an AWwiseBlendWeightManager. Cached on registration, as SetWeight() needs it on every call. */
+	UPROPERTY(Transient)
+	AWwiseBlendWeightManager* OwningManager = nullptr;
+
 	UPROPERTY(EditAnywhere)
 	UAkRtpc* BlendParameter;
 
 	UPROPERTY(EditAnywhere)
 	TSet<const ABlendArea*> BlendAreas;
+
+	/** The RTPC value last sent to the sound engine, used for skipping redundant updates. */
+	float LastSubmittedPercentage = -1.f;
+
+	float CurrentWeight = 0.f;
+
+	enum class EBlendEventState : uint8
+	{
+		Stopped,
+		Playing,
+		Stopping
+	};
+
+	/** The lifetime state of a manager posted event, advanced by AWwiseBlendWeightManager. */
+	EBlendEventState BlendEventState = EBlendEventState::Stopped;
+
+	float ActiveTime = 0.f;
+
+	friend class AWwiseBlendWeightManager;
 };
@@ -13,6 +13,8 @@ subjected to the respective product licensing terms.
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "BlendWeightManager.h"
+#include "BlendRtpcSubmitter.h"
+#include "BlendEventPreloader.h"
 #include "WwiseBlendWeightManager.generated.h"
 
 UCLASS()
@@ -29,6 +31,7 @@ protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetBlendPosition(FVector& OutPosition) const override;
+	virtual bool ShouldSmoothWeights() const override;
 
 public:	
 
@@ -37,17 +40,188 @@ public:
 	UPROPERTY(EditAnywhere)
 	bool bUseSpatialAudioListener;
 
+	/** 
+	* Gathers the RTPC changes of all UWwiseBlendAreaEvent components for a frame and submits them together
+	* at the end of the manager tick, grouped by game object. The sound engine still receives one call per value,
+	* as it has no multi-value setter. When disabled, each component sets its RTPC value through its own UAkComponent.
+	*/
+	UPROPERTY(EditAnywhere)
+	bool bBatchRtpcSubmission = true;
+
+	/** 
+	* Queues an RTPC value change for the batched submission of the current frame.
+	*
+	* @return false if batching is disabled, in which case the caller should set the value itself
+	*/
+	bool QueueRtpcValue(const FBlendRtpcValue& RtpcValue);
+
+	/** 
+	* Leaves the smoothing of the blend RTPCs to the sound engine: instead of smoothing the weights every tick,
+	* each RTPC change is sent once with an interpolation time of 'SmoothingTimeConstant'.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Smoothing")
+	bool bInterpolateRtpcInSoundEngine = false;
+
+	/** The interpolation time UWwiseBlendAreaEvent components pass along with their RTPC changes. */
+	int32 GetRtpcInterpolationTimeMs() const;
+
+	/** 
+	* Lets the manager decide which UWwiseBlendAreaEvent components are playing, instead of each component
+	* posting its event whenever the weight is above zero. Events are ranked by their current weight and only
+	* the highest ranked ones within the limits below are kept alive.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Voice Budget")
+	bool bUseVoiceBudget = false;
+
+	/** The maximum number of simultaneously playing events. Zero means no limit. */
+	UPROPERTY(EditAnywhere, Category = "Voice Budget", meta = (ClampMin = "0", EditCondition = "bUseVoiceBudget"))
+	int32 MaxActiveEvents = 0;
+
+	/** The weight an event must reach before it is started. */
+	UPROPERTY(EditAnywhere, Category = "Voice Budget", meta = (ClampMin = "0", ClampMax = "1", EditCondition = "bUseVoiceBudget"))
+	float StartWeight = 0.05f;
+
+	/** The weight at or below which a playing event is stopped. Keep below StartWeight to avoid thrashing at area boundaries. */
+	UPROPERTY(EditAnywhere, Category = "Voice Budget", meta = (ClampMin = "0", ClampMax = "1", EditCondition = "bUseVoiceBudget"))
+	float StopWeight = 0.f;
+
+	/** The minimum time in seconds an event is kept playing once started. Such events still count against MaxActiveEvents. */
+	UPROPERTY(EditAnywhere, Category = "Voice Budget", meta = (ClampMin = "0", EditCondition = "bUseVoiceBudget"))
+	float MinimumEventLifetime = 2.f;
+
+	int32 GetActiveEventCount() const { return ActiveEventCount; }
+
+	/** Event starts and stops per second, measured over the latest full second. */
+	float GetEventChurnPerSecond() const { return EventChurnPerSecond; }
+
+	/** Replaces the sound engine submission point, e.g. with FRecordingRtpcSubmitter when running without Wwise. */
+	void SetRtpcSubmitter(TSharedPtr<IBlendRtpcSubmitter> InRtpcSubmitter);
+
+	/** 
+	* Preloads the event of a UWwiseBlendAreaEvent before the listener enters one of its blend areas, so that streamed
+	* media is ready when the event is posted. The time to entry is estimated from the listener velocity and the
+	* distance to the area boundaries.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Prefetch")
+	bool bPrefetchEvents = false;
+
+	/** How many seconds before the estimated entry into an area its event is preloaded. */
+	UPROPERTY(EditAnywhere, Category = "Prefetch", meta = (ClampMin = "0", EditCondition = "bPrefetchEvents"))
+	float PrefetchLeadTime = 3.f;
+
+	/** 
+	* How many seconds an event stays preloaded after the listener has left its areas and is no longer approaching them.
+	* An event is never released while it is playing, nor while another component with the same event still needs it.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Prefetch", meta = (ClampMin = "0", EditCondition = "bPrefetchEvents"))
+	float PrefetchReleaseDelay = 5.f;
+
+	/** Seconds between time to entry estimates. */
+	UPROPERTY(EditAnywhere, Category = "Prefetch", meta = (ClampMin = "0", EditCondition = "bPrefetchEvents"))
+	float PrefetchCheckInterval = 0.25f;
+
+	/** The number of distinct event assets currently preloaded. */
+	int32 GetPrefetchedEventCount() const { return PrefetchedEventCount; }
+
+	/** Replaces the event loading point, e.g. with FRecordingEventPreloader when running without Wwise. */
+	void SetEventPreloader(TSharedPtr<IBlendEventPreloader> InEventPreloader);
+
+	/** 
+	* Gathers the spatial audio rooms of the world again. Done automatically at BeginPlay and whenever a level is
+	* added to or removed from the world; call it after spawning room components at runtime.
+	*/
+	void RefreshRooms();
+
 private:
 
+	void SubmitQueuedRtpcValues();
+	void UpdateEventLifetimes(float DeltaTime);
+	void UpdatePrefetch(float DeltaTime);
+	void ReleasePrefetchedEvents();
+
+	/** Adds a reference of an entry of BlendAreaEvents to an event asset, preloading the asset on its first reference. */
+	void AcquirePrefetch(const int32 Index, class UAkAudioEvent* AudioEvent);
+
+	/** Drops the reference of an entry of BlendAreaEvents, releasing the asset once no entry references it. */
+	void ReleasePrefetch(const int32 Index);
+
+	/** Returns the estimated seconds until the listener enters any blend area of the event, or MAX_flt if it is not approaching one. */
+	float EstimateTimeToEntry(const class UWwiseBlendAreaEvent* Event, const FVector2D& Position) const;
+
+	UPROPERTY()
+	TArray<class UWwiseBlendAreaEvent*> BlendAreaEvents;
+
+	TArray<int32> RankedEvents;
+	int32 ActiveEventCount = 0;
+	int32 EventChurnCount = 0;
+	float EventChurnTimer = 0.f;
+	float EventChurnPerSecond = 0.f;
+
+	TSharedPtr<IBlendRtpcSubmitter> RtpcSubmitter;
+	TArray<FBlendRtpcValue> QueuedRtpcValues;
+
+	TSharedPtr<IBlendEventPreloader> EventPreloader;
+
+	/** Per entry of BlendAreaEvents: the event asset the entry holds a prefetch reference to, if any. */
+	UPROPERTY()
+	TArray<class UAkAudioEvent*> PrefetchedAudioEvents;
+
+	/** Per entry of BlendAreaEvents: seconds since the entry last needed its prefetched event. */
+	TArray<float> PrefetchIdleTimes;
+
+	/** 
+	* The number of entries referencing each event asset. Components may share an event, so the data is preloaded
+	* on the first reference and released with the last one. Entries are kept at zero, so that they are not re-added.
+	*/
+	TMap<class UAkAudioEvent*, int32> PrefetchReferences;
+
+	int32 PrefetchedEventCount = 0;
+	float PrefetchTimer = 0.f;
+
+	/** The listener velocity on the XY-plane, smoothed over a few frames. */
+	FVector2D ListenerVelocity = FVector2D::ZeroVector;
+	FVector PreviousListenerPosition = FVector::ZeroVector;
+	bool bHasPreviousListenerPosition = false;
+
 	UPROPERTY(EditAnywhere)
 	UAkStateValue* InsideRoomState;
 
 	UPROPERTY(EditAnywhere)
 	UAkStateValue* NoneState;
 
+	/** 
+	* While the listener is inside a spatial audio room, the rooms it was found in are re-validated every tick.
+	* From outside, the room search first rejects the rooms by their bounds, so it stays cheap without a throttle.
+	* This interval throttles it further.
+	*/
 	UPROPERTY(EditAnywhere, meta = (ClampMin = "0"))
 	float RoomContainmentCheckInterval = 0.f;
 
 	float Timer = 0.f;
 	bool bInsideRoom = true;
+
+	/** CachedRooms is reserved for this many rooms, so that entering nested rooms does not grow it. */
+	static constexpr int32 ExpectedOverlappingRooms = 4;
+
+	/** The rooms that contained the listener on the latest full room search. */
+	TArray<TWeakObjectPtr<class UAkRoomComponent>> CachedRooms;
+
+	/** All room components of the world, searched instead of FAkAudioDevice::FindRoomComponentsAtLocation(). */
+	TArray<TWeakObjectPtr<class UAkRoomComponent>> WorldRooms;
+
+	FDelegateHandle LevelAddedHandle;
+	FDelegateHandle LevelRemovedHandle;
+
+	void OnLevelsChanged(ULevel* Level, UWorld* World);
+
+	void UpdateRoomContainment(float DeltaTime);
+	bool IsInsideCachedRoom(const FVector& Position) const;
+
+	/** Gathers the rooms containing the position into CachedRooms. */
+	void FindRoomsAtLocation(const FVector& Position);
+
+	/** Rejects by the bounds of the room volume before the exact containment test. */
+	static bool IsInsideRoom(const class UAkRoomComponent* Room, const FVector& Position);
+	void OnRoomEntered();
+	void OnRoomExited();
 };